@@ -0,0 +1,317 @@
+#pragma once
+
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+// поиск нескольких различающихся маршрутов между парой вершин
+namespace graph {
+
+// ограничения на альтернативные маршруты
+struct AlternativeRouteSettings {
+    double max_stretch = 1.5; // вес альтернативы не больше max_stretch весов оптимального маршрута
+    double max_sharing = 0.7; // вес рёбер, общих с уже выбранным маршрутом, не больше max_sharing его веса
+};
+
+/*
+альтернативные маршруты по двум деревьям кратчайших путей: прямому из from и обратному в to (по входящим дугам).
+Кандидат - маршрут с одним отклонением: путь прямого дерева до начала ребра вне дерева, это ребро и путь
+обратного дерева от его конца. Так получаются и маршруты через любую вершину (обход по плато - общей части
+деревьев), и маршруты по параллельным рёбрам других автобусов. Все кандидаты оцениваются по двум деревьям
+без повторных поисков и перебираются по возрастанию веса: берутся не слишком длинные, без повторных вершин
+и не слишком похожие на уже выбранные. Входящие дуги строятся один раз при создании
+*/
+template <typename Weight>
+class AlternativeRouteSearch {
+private:
+    using Graph = CompactGraph<Weight>;
+
+public:
+    using RouteInfo = typename RouterBase<Weight>::RouteInfo;
+
+    explicit AlternativeRouteSearch(const Graph& graph);
+
+    /*
+    до count маршрутов from -> to по возрастанию веса, первый - оптимальный; пустой вектор - маршрута нет.
+    is_allowed(edges) отбрасывает альтернативы, бессмысленные для вызывающего. Счётчики: просмотренные вершины
+    и релаксированные рёбра обоих поисков
+    */
+    template <typename IsAllowed>
+    std::vector<RouteInfo> FindRoutes(VertexId from, VertexId to, size_t count, const AlternativeRouteSettings& settings,
+                                      IsAllowed is_allowed, SearchStats& stats) const;
+
+private:
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+    static constexpr Weight ZERO_WEIGHT{};
+
+    // входящая дуга: начало, id ребра и вес
+    struct InArc {
+        uint32_t from;
+        uint32_t edge_id;
+        Weight weight;
+    };
+
+    // дерево кратчайших путей: вес пути и ребро дерева у вершины (в прямом - входящее, в обратном - исходящее)
+    struct Tree {
+        std::vector<std::optional<Weight>> weights;
+        std::vector<EdgeId> edges;
+    };
+
+    // кандидат: вес маршрута через ребро отклонения, ребро и его начало
+    struct Candidate {
+        Weight weight;
+        EdgeId edge_id;
+        VertexId vertex;
+    };
+
+    /*
+    дерево поиска Дейкстры из root (forward) или в root (по входящим дугам); после раскрытия target
+    вершины тяжелее max_stretch его весов не раскрываются и в дерево не входят
+    */
+    Tree BuildTree(VertexId root, bool forward, VertexId target, double max_stretch, SearchStats& stats) const;
+
+    /*
+    рёбра маршрута: путь прямого дерева до vertex, ребро отклонения via_edge из vertex (NO_EDGE - без него)
+    и путь обратного дерева от конца ребра (или от vertex)
+    */
+    std::vector<EdgeId> CollectEdges(const Tree& forward_tree, const Tree& backward_tree, VertexId vertex,
+                                     EdgeId via_edge) const;
+
+    // нет ли в маршруте повторной вершины (прямой и обратный пути могут пересечься)
+    bool IsSimple(VertexId from, const std::vector<EdgeId>& edges, std::vector<uint32_t>& marks, uint32_t mark) const;
+
+    // вес рёбер edges (отсортированы), общих с отсортированными рёбрами other
+    Weight ComputeSharedWeight(const std::vector<EdgeId>& edges, const std::vector<EdgeId>& other) const;
+
+    const Graph& graph_;
+    std::vector<uint32_t> in_offsets_; // входящие дуги вершины v - [in_offsets_[v], in_offsets_[v + 1])
+    std::vector<InArc> in_arcs_;
+};
+
+template <typename Weight>
+AlternativeRouteSearch<Weight>::AlternativeRouteSearch(const Graph& graph)
+    : graph_(graph)
+    , in_offsets_(graph.GetVertexCount() + 1, 0)
+{
+    const size_t vertex_count = graph.GetVertexCount();
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (const auto& arc : graph.GetArcs(vertex)) {
+            if (arc.weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+            ++in_offsets_[arc.to + 1];
+        }
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        in_offsets_[vertex + 1] += in_offsets_[vertex];
+    }
+    in_arcs_.resize(in_offsets_.back());
+    std::vector<uint32_t> fill(in_offsets_.begin(), in_offsets_.end() - 1);
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (const auto& arc : graph.GetArcs(vertex)) {
+            in_arcs_[fill[arc.to]++] = {static_cast<uint32_t>(vertex), arc.edge_id, arc.weight};
+        }
+    }
+}
+
+template <typename Weight>
+template <typename IsAllowed>
+std::vector<typename AlternativeRouteSearch<Weight>::RouteInfo>
+AlternativeRouteSearch<Weight>::FindRoutes(VertexId from, VertexId to, size_t count,
+                                           const AlternativeRouteSettings& settings, IsAllowed is_allowed,
+                                           SearchStats& stats) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    stats = {};
+    std::vector<RouteInfo> routes;
+    if (count == 0) {
+        return routes;
+    }
+    if (from == to) {
+        routes.push_back({ZERO_WEIGHT, {}});
+        return routes;
+    }
+
+    const Tree forward_tree = BuildTree(from, true, to, settings.max_stretch, stats);
+    if (!forward_tree.weights[to]) {
+        return routes;
+    }
+    const Tree backward_tree = BuildTree(to, false, from, settings.max_stretch, stats);
+    const Weight best_weight = *forward_tree.weights[to];
+    const double max_weight = settings.max_stretch * static_cast<double>(best_weight);
+
+    // кандидаты - рёбра вне прямого дерева, концы которых есть в обоих деревьях
+    std::vector<Candidate> candidates;
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        if (!forward_tree.weights[vertex]) {
+            continue;
+        }
+        for (const auto& arc : graph_.GetArcs(vertex)) {
+            if (!backward_tree.weights[arc.to] || forward_tree.edges[arc.to] == arc.edge_id) {
+                continue;
+            }
+            const Weight weight = *forward_tree.weights[vertex] + arc.weight + *backward_tree.weights[arc.to];
+            if (static_cast<double>(weight) <= max_weight) {
+                candidates.push_back({weight, arc.edge_id, static_cast<VertexId>(vertex)});
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+        return std::tie(lhs.weight, lhs.edge_id) < std::tie(rhs.weight, rhs.edge_id);
+    });
+
+    std::vector<std::vector<EdgeId>> sorted_route_edges; // рёбра выбранных маршрутов для оценки сходства
+    std::vector<uint32_t> marks(vertex_count, 0);
+    uint32_t mark = 0;
+    const auto try_add_route = [&](std::vector<EdgeId> edges, bool is_optimal) {
+        // вес складывается от начала маршрута, как у остальных маршрутизаторов
+        Weight weight = ZERO_WEIGHT;
+        for (const EdgeId edge_id : edges) {
+            weight = weight + graph_.GetEdge(edge_id).weight;
+        }
+        std::vector<EdgeId> sorted_edges = edges;
+        std::sort(sorted_edges.begin(), sorted_edges.end());
+        const bool is_distinct = std::all_of(sorted_route_edges.begin(), sorted_route_edges.end(),
+            [&](const std::vector<EdgeId>& other) {
+                return sorted_edges != other && static_cast<double>(ComputeSharedWeight(sorted_edges, other))
+                    <= settings.max_sharing * static_cast<double>(weight);
+            });
+        if (!is_distinct || !IsSimple(from, edges, marks, ++mark) || (!is_optimal && !is_allowed(edges))) {
+            return;
+        }
+        routes.push_back({weight, std::move(edges)});
+        sorted_route_edges.push_back(std::move(sorted_edges));
+    };
+
+    // первый - оптимальный маршрут прямого дерева, затем кандидаты по возрастанию веса
+    try_add_route(CollectEdges(forward_tree, backward_tree, to, NO_EDGE), true);
+    for (const Candidate& candidate : candidates) {
+        if (routes.size() == count) {
+            break;
+        }
+        try_add_route(CollectEdges(forward_tree, backward_tree, candidate.vertex, candidate.edge_id), false);
+    }
+
+    std::stable_sort(routes.begin(), routes.end(), [](const RouteInfo& lhs, const RouteInfo& rhs) {
+        return lhs.weight < rhs.weight;
+    });
+    return routes;
+}
+
+template <typename Weight>
+typename AlternativeRouteSearch<Weight>::Tree
+AlternativeRouteSearch<Weight>::BuildTree(VertexId root, bool forward, VertexId target, double max_stretch,
+                                          SearchStats& stats) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    Tree tree{std::vector<std::optional<Weight>>(vertex_count), std::vector<EdgeId>(vertex_count, NO_EDGE)};
+
+    using QueueItem = std::pair<Weight, VertexId>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    tree.weights[root] = ZERO_WEIGHT;
+    queue.push({ZERO_WEIGHT, root});
+    std::optional<double> bound;
+    const auto relax = [&](VertexId vertex, EdgeId edge_id, Weight weight) {
+        ++stats.relaxed_edges;
+        if (!tree.weights[vertex] || weight < *tree.weights[vertex]) {
+            tree.weights[vertex] = weight;
+            tree.edges[vertex] = edge_id;
+            queue.push({weight, vertex});
+        }
+    };
+    while (!queue.empty()) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (*tree.weights[vertex] < weight) {
+            continue; // устаревший элемент кучи
+        }
+        if (bound && static_cast<double>(weight) > *bound) {
+            break; // вершины дальше не войдут ни в один допустимый маршрут
+        }
+        ++stats.settled_vertices;
+        if (vertex == target) {
+            bound = max_stretch * static_cast<double>(weight);
+        }
+        if (forward) {
+            for (const auto& arc : graph_.GetArcs(vertex)) {
+                relax(arc.to, arc.edge_id, weight + arc.weight);
+            }
+        } else {
+            for (uint32_t i = in_offsets_[vertex]; i < in_offsets_[vertex + 1]; ++i) {
+                relax(in_arcs_[i].from, in_arcs_[i].edge_id, weight + in_arcs_[i].weight);
+            }
+        }
+    }
+
+    // нераскрытые вершины за границей не относятся к дереву
+    while (!queue.empty()) {
+        const VertexId vertex = queue.top().second;
+        queue.pop();
+        if (bound && static_cast<double>(*tree.weights[vertex]) > *bound) {
+            tree.weights[vertex].reset();
+            tree.edges[vertex] = NO_EDGE;
+        }
+    }
+    return tree;
+}
+
+template <typename Weight>
+std::vector<EdgeId> AlternativeRouteSearch<Weight>::CollectEdges(const Tree& forward_tree, const Tree& backward_tree,
+                                                                 VertexId vertex, EdgeId via_edge) const {
+    std::vector<EdgeId> edges;
+    for (VertexId current = vertex; forward_tree.edges[current] != NO_EDGE;
+         current = graph_.GetEdge(forward_tree.edges[current]).from) {
+        edges.push_back(forward_tree.edges[current]);
+    }
+    std::reverse(edges.begin(), edges.end());
+    if (via_edge != NO_EDGE) {
+        edges.push_back(via_edge);
+        vertex = graph_.GetEdge(via_edge).to;
+    }
+    for (VertexId current = vertex; backward_tree.edges[current] != NO_EDGE;
+         current = graph_.GetEdge(backward_tree.edges[current]).to) {
+        edges.push_back(backward_tree.edges[current]);
+    }
+    return edges;
+}
+
+template <typename Weight>
+bool AlternativeRouteSearch<Weight>::IsSimple(VertexId from, const std::vector<EdgeId>& edges,
+                                              std::vector<uint32_t>& marks, uint32_t mark) const {
+    marks[from] = mark;
+    for (const EdgeId edge_id : edges) {
+        const VertexId vertex = graph_.GetEdge(edge_id).to;
+        if (marks[vertex] == mark) {
+            return false;
+        }
+        marks[vertex] = mark;
+    }
+    return true;
+}
+
+template <typename Weight>
+Weight AlternativeRouteSearch<Weight>::ComputeSharedWeight(const std::vector<EdgeId>& edges,
+                                                           const std::vector<EdgeId>& other) const {
+    std::vector<EdgeId> shared_edges;
+    std::set_intersection(edges.begin(), edges.end(), other.begin(), other.end(), std::back_inserter(shared_edges));
+    Weight weight = ZERO_WEIGHT;
+    for (const EdgeId edge_id : shared_edges) {
+        weight = weight + graph_.GetEdge(edge_id).weight;
+    }
+    return weight;
+}
+
+}  // namespace graph
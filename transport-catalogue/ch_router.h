@@ -0,0 +1,564 @@
+#pragma once
+
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// поиск кратчайшего пути по иерархии сжатия (Contraction Hierarchies)
+namespace graph {
+
+/*
+маршрутизатор с предрасчётом иерархии: вершины по очереди стягиваются,
+вместо путей через стянутую вершину добавляются рёбра-сокращения (shortcut).
+Запрос - двунаправленный поиск только вверх по иерархии,
+сокращения в ответе раскрываются обратно в исходные рёбра графа
+*/
+template <typename Weight>
+class ContractionHierarchyRouter : public RouterBase<Weight> {
+private:
+    using Graph = CompactGraph<Weight>;
+
+public:
+    using typename RouterBase<Weight>::RouteInfo;
+
+    explicit ContractionHierarchyRouter(const Graph& graph);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    std::optional<RouteInfo> BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const override;
+
+    /*
+    веса всех пар корзинами: полный обратный поиск вверх из каждой вершины to оставляет в достигнутых вершинах
+    записи (номер цели, вес до неё), затем полный прямой поиск вверх из каждой вершины from
+    сочетает свои веса с записями корзин просмотренных вершин
+    */
+    std::vector<std::optional<Weight>> BuildWeights(const std::vector<VertexId>& from,
+                                                    const std::vector<VertexId>& to) const override;
+
+    // порядок стягивания и сокращения при равномерном масштабировании остаются верными, меняются только веса
+    bool ScaleWeights(double factor) override {
+        if (!std::is_floating_point_v<Weight>) {
+            return false;
+        }
+        for (ChEdge& edge : ch_edges_) {
+            edge.weight = static_cast<Weight>(edge.weight * factor);
+        }
+        for (UpwardArcs* upward : { &forward_arcs_, &backward_arcs_ }) {
+            for (Arc& arc : upward->arcs) {
+                arc.weight = static_cast<Weight>(arc.weight * factor);
+            }
+        }
+        return true;
+    }
+
+    // количество добавленных рёбер-сокращений
+    size_t GetShortcutCount() const;
+
+private:
+    static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr Weight INFINITE_WEIGHT = std::numeric_limits<Weight>::max();
+
+    // лимит вершин, просматриваемых при поиске свидетеля (пути в обход стягиваемой вершины)
+    static constexpr size_t WITNESS_SETTLED_LIMIT = 500;
+
+    // ребро иерархии: исходное ребро графа (id < GetEdgeCount()) или сокращение из двух рёбер иерархии
+    struct ChEdge {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+        size_t first_child = NONE;
+        size_t second_child = NONE;
+    };
+
+    // дуга списка смежности: соседняя вершина, вес и id ребра иерархии
+    struct Arc {
+        VertexId other;
+        Weight weight;
+        size_t ch_edge;
+    };
+
+    // плоский список дуг, ведущих вверх по иерархии: offsets[v]..offsets[v + 1]
+    struct UpwardArcs {
+        std::vector<size_t> offsets;
+        std::vector<Arc> arcs;
+    };
+
+    // состояние одного направления поиска
+    struct SearchSpace {
+        std::vector<Weight> weights;
+        std::vector<size_t> parent_edges;
+        std::vector<VertexId> touched;
+    };
+
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    // стягивает вершины в порядке приоритета и заполняет ch_edges_ и ranks_
+    void Contract(const Graph& graph);
+
+    // количество сокращений при стягивании vertex; при add_shortcuts = true сокращения добавляются
+    size_t ContractVertex(VertexId vertex, bool add_shortcuts,
+                          std::vector<std::vector<Arc>>& out_arcs, std::vector<std::vector<Arc>>& in_arcs,
+                          const std::vector<bool>& contracted);
+
+    // есть ли путь from -> to в обход vertex не длиннее max_weight
+    bool HasWitness(VertexId from, VertexId to, VertexId vertex, Weight max_weight,
+                    const std::vector<std::vector<Arc>>& out_arcs, const std::vector<bool>& contracted);
+
+    // добавляет ребро иерархии или уменьшает вес уже существующей дуги from -> to
+    void AddArc(VertexId from, VertexId to, Weight weight, size_t ch_edge,
+                std::vector<std::vector<Arc>>& out_arcs, std::vector<std::vector<Arc>>& in_arcs);
+
+    // строит плоские списки дуг вверх по иерархии для прямого и обратного поиска
+    void BuildUpwardArcs(size_t vertex_count);
+
+    // один шаг поиска в одном направлении, обновляет лучший вес через точку встречи
+    void SettleVertex(Queue& queue, SearchSpace& space, const SearchSpace& opposite, const UpwardArcs& upward,
+                      Weight& best_weight, VertexId& meeting_vertex, SearchStats& stats) const;
+
+    // полный поиск вверх по иерархии из source, достигнутые вершины остаются в space.touched
+    void SearchUpward(VertexId source, const UpwardArcs& upward, SearchSpace& space) const;
+
+    // раскрывает ребро иерархии в последовательность исходных рёбер
+    void UnpackEdge(size_t ch_edge, std::vector<EdgeId>& edges) const;
+
+    size_t original_edge_count_ = 0;
+    std::vector<ChEdge> ch_edges_;
+    std::vector<size_t> ranks_;
+    UpwardArcs forward_arcs_;
+    UpwardArcs backward_arcs_;
+
+    // веса локального поиска свидетелей, нужны только при построении
+    std::vector<Weight> witness_weights_;
+    std::vector<VertexId> witness_touched_;
+};
+
+template <typename Weight>
+ContractionHierarchyRouter<Weight>::ContractionHierarchyRouter(const Graph& graph)
+    : original_edge_count_(graph.GetEdgeCount())
+{
+    // исходные рёбра занимают первые id рёбер иерархии
+    ch_edges_.resize(graph.GetEdgeCount());
+    for (VertexId vertex = 0; vertex < graph.GetVertexCount(); ++vertex) {
+        for (const auto& arc : graph.GetArcs(vertex)) {
+            if (arc.weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+            ch_edges_[arc.edge_id] = {vertex, arc.to, arc.weight};
+        }
+    }
+    witness_weights_.assign(graph.GetVertexCount(), INFINITE_WEIGHT);
+    Contract(graph);
+    BuildUpwardArcs(graph.GetVertexCount());
+    witness_weights_ = {};
+    witness_touched_ = {};
+}
+
+template <typename Weight>
+size_t ContractionHierarchyRouter<Weight>::GetShortcutCount() const {
+    return ch_edges_.size() - original_edge_count_;
+}
+
+template <typename Weight>
+void ContractionHierarchyRouter<Weight>::Contract(const Graph& graph) {
+    const size_t vertex_count = graph.GetVertexCount();
+    std::vector<std::vector<Arc>> out_arcs(vertex_count);
+    std::vector<std::vector<Arc>> in_arcs(vertex_count);
+    for (size_t ch_edge = 0; ch_edge < ch_edges_.size(); ++ch_edge) {
+        const auto& edge = ch_edges_[ch_edge];
+        if (edge.from != edge.to) { // петли не участвуют в кратчайших путях
+            AddArc(edge.from, edge.to, edge.weight, ch_edge, out_arcs, in_arcs);
+        }
+    }
+
+    // приоритет вершины: разность рёбер (сокращения минус удаляемые дуги) плюс число стянутых соседей
+    std::vector<bool> contracted(vertex_count, false);
+    std::vector<size_t> contracted_neighbors(vertex_count, 0);
+    const auto compute_priority = [&](VertexId vertex) {
+        const size_t shortcuts = ContractVertex(vertex, false, out_arcs, in_arcs, contracted);
+        size_t removed_arcs = 0;
+        for (const auto& arc : out_arcs[vertex]) {
+            removed_arcs += contracted[arc.other] ? 0 : 1;
+        }
+        for (const auto& arc : in_arcs[vertex]) {
+            removed_arcs += contracted[arc.other] ? 0 : 1;
+        }
+        return static_cast<long long>(shortcuts) - static_cast<long long>(removed_arcs)
+             + static_cast<long long>(contracted_neighbors[vertex]);
+    };
+
+    using PriorityItem = std::pair<long long, VertexId>;
+    std::priority_queue<PriorityItem, std::vector<PriorityItem>, std::greater<PriorityItem>> queue;
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        queue.push({compute_priority(vertex), vertex});
+    }
+
+    ranks_.assign(vertex_count, 0);
+    size_t rank = 0;
+    while (!queue.empty()) {
+        const VertexId vertex = queue.top().second;
+        queue.pop();
+        if (contracted[vertex]) {
+            continue;
+        }
+        // ленивое обновление: если приоритет вырос, вершина возвращается в очередь
+        const long long priority = compute_priority(vertex);
+        if (!queue.empty() && priority > queue.top().first) {
+            queue.push({priority, vertex});
+            continue;
+        }
+        ContractVertex(vertex, true, out_arcs, in_arcs, contracted);
+        contracted[vertex] = true;
+        ranks_[vertex] = rank++;
+        for (const auto& arc : out_arcs[vertex]) {
+            ++contracted_neighbors[arc.other];
+        }
+        for (const auto& arc : in_arcs[vertex]) {
+            ++contracted_neighbors[arc.other];
+        }
+    }
+}
+
+template <typename Weight>
+size_t ContractionHierarchyRouter<Weight>::ContractVertex(VertexId vertex, bool add_shortcuts,
+                                                          std::vector<std::vector<Arc>>& out_arcs,
+                                                          std::vector<std::vector<Arc>>& in_arcs,
+                                                          const std::vector<bool>& contracted) {
+    size_t shortcut_count = 0;
+    // копии: при добавлении сокращений списки соседей могут перераспределяться
+    const std::vector<Arc> incoming = in_arcs[vertex];
+    const std::vector<Arc> outgoing = out_arcs[vertex];
+    for (const auto& in_arc : incoming) {
+        if (contracted[in_arc.other]) {
+            continue;
+        }
+        for (const auto& out_arc : outgoing) {
+            if (contracted[out_arc.other] || in_arc.other == out_arc.other) {
+                continue;
+            }
+            const Weight shortcut_weight = in_arc.weight + out_arc.weight;
+            if (HasWitness(in_arc.other, out_arc.other, vertex, shortcut_weight, out_arcs, contracted)) {
+                continue;
+            }
+            ++shortcut_count;
+            if (add_shortcuts) {
+                ch_edges_.push_back({in_arc.other, out_arc.other, shortcut_weight, in_arc.ch_edge, out_arc.ch_edge});
+                AddArc(in_arc.other, out_arc.other, shortcut_weight, ch_edges_.size() - 1, out_arcs, in_arcs);
+            }
+        }
+    }
+    return shortcut_count;
+}
+
+template <typename Weight>
+bool ContractionHierarchyRouter<Weight>::HasWitness(VertexId from, VertexId to, VertexId vertex, Weight max_weight,
+                                                    const std::vector<std::vector<Arc>>& out_arcs,
+                                                    const std::vector<bool>& contracted) {
+    for (const VertexId touched : witness_touched_) {
+        witness_weights_[touched] = INFINITE_WEIGHT;
+    }
+    witness_touched_.clear();
+
+    Queue queue;
+    queue.push({ZERO_WEIGHT, from});
+    witness_weights_[from] = ZERO_WEIGHT;
+    witness_touched_.push_back(from);
+    size_t settled = 0;
+    while (!queue.empty() && settled < WITNESS_SETTLED_LIMIT) {
+        const auto [weight, current] = queue.top();
+        queue.pop();
+        if (weight > max_weight) {
+            return false;
+        }
+        if (weight > witness_weights_[current]) {
+            continue;
+        }
+        if (current == to) {
+            return true;
+        }
+        ++settled;
+        for (const auto& arc : out_arcs[current]) {
+            if (arc.other == vertex || contracted[arc.other]) {
+                continue;
+            }
+            const Weight candidate_weight = weight + arc.weight;
+            if (candidate_weight < witness_weights_[arc.other]) {
+                if (witness_weights_[arc.other] == INFINITE_WEIGHT) {
+                    witness_touched_.push_back(arc.other);
+                }
+                witness_weights_[arc.other] = candidate_weight;
+                queue.push({candidate_weight, arc.other});
+            }
+        }
+    }
+    return false; // свидетель не найден или поиск прерван по лимиту: сокращение добавляется
+}
+
+template <typename Weight>
+void ContractionHierarchyRouter<Weight>::AddArc(VertexId from, VertexId to, Weight weight, size_t ch_edge,
+                                                std::vector<std::vector<Arc>>& out_arcs,
+                                                std::vector<std::vector<Arc>>& in_arcs) {
+    auto out_it = std::find_if(out_arcs[from].begin(), out_arcs[from].end(),
+                               [to](const Arc& arc) { return arc.other == to; });
+    if (out_it == out_arcs[from].end()) {
+        out_arcs[from].push_back({to, weight, ch_edge});
+        in_arcs[to].push_back({from, weight, ch_edge});
+        return;
+    }
+    if (weight < out_it->weight) { // из параллельных рёбер остаётся самое лёгкое
+        *out_it = {to, weight, ch_edge};
+        auto in_it = std::find_if(in_arcs[to].begin(), in_arcs[to].end(),
+                                  [from](const Arc& arc) { return arc.other == from; });
+        *in_it = {from, weight, ch_edge};
+    }
+}
+
+template <typename Weight>
+void ContractionHierarchyRouter<Weight>::BuildUpwardArcs(size_t vertex_count) {
+    forward_arcs_.offsets.assign(vertex_count + 1, 0);
+    backward_arcs_.offsets.assign(vertex_count + 1, 0);
+    for (const auto& edge : ch_edges_) {
+        if (ranks_[edge.from] < ranks_[edge.to]) {
+            ++forward_arcs_.offsets[edge.from + 1];
+        } else if (ranks_[edge.from] > ranks_[edge.to]) {
+            ++backward_arcs_.offsets[edge.to + 1];
+        }
+    }
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        forward_arcs_.offsets[vertex + 1] += forward_arcs_.offsets[vertex];
+        backward_arcs_.offsets[vertex + 1] += backward_arcs_.offsets[vertex];
+    }
+    forward_arcs_.arcs.resize(forward_arcs_.offsets.back());
+    backward_arcs_.arcs.resize(backward_arcs_.offsets.back());
+
+    std::vector<size_t> forward_fill(forward_arcs_.offsets.begin(), forward_arcs_.offsets.end() - 1);
+    std::vector<size_t> backward_fill(backward_arcs_.offsets.begin(), backward_arcs_.offsets.end() - 1);
+    for (size_t ch_edge = 0; ch_edge < ch_edges_.size(); ++ch_edge) {
+        const auto& edge = ch_edges_[ch_edge];
+        if (ranks_[edge.from] < ranks_[edge.to]) {
+            forward_arcs_.arcs[forward_fill[edge.from]++] = {edge.to, edge.weight, ch_edge};
+        } else if (ranks_[edge.from] > ranks_[edge.to]) {
+            backward_arcs_.arcs[backward_fill[edge.to]++] = {edge.from, edge.weight, ch_edge};
+        }
+    }
+}
+
+template <typename Weight>
+void ContractionHierarchyRouter<Weight>::SettleVertex(Queue& queue, SearchSpace& space, const SearchSpace& opposite,
+                                                      const UpwardArcs& upward, Weight& best_weight,
+                                                      VertexId& meeting_vertex, SearchStats& stats) const {
+    const auto [weight, vertex] = queue.top();
+    queue.pop();
+    if (weight > space.weights[vertex]) {
+        return; // устаревший элемент кучи
+    }
+    ++stats.settled_vertices;
+    if (opposite.weights[vertex] != INFINITE_WEIGHT && weight + opposite.weights[vertex] < best_weight) {
+        best_weight = weight + opposite.weights[vertex];
+        meeting_vertex = vertex;
+    }
+    for (size_t i = upward.offsets[vertex]; i < upward.offsets[vertex + 1]; ++i) {
+        const auto& arc = upward.arcs[i];
+        const Weight candidate_weight = weight + arc.weight;
+        ++stats.relaxed_edges;
+        if (candidate_weight < space.weights[arc.other]) {
+            if (space.weights[arc.other] == INFINITE_WEIGHT) {
+                space.touched.push_back(arc.other);
+            }
+            space.weights[arc.other] = candidate_weight;
+            space.parent_edges[arc.other] = arc.ch_edge;
+            queue.push({candidate_weight, arc.other});
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<typename ContractionHierarchyRouter<Weight>::RouteInfo>
+ContractionHierarchyRouter<Weight>::BuildRoute(VertexId from, VertexId to) const {
+    SearchStats stats;
+    return BuildRouteWithStats(from, to, stats);
+}
+
+template <typename Weight>
+std::optional<typename ContractionHierarchyRouter<Weight>::RouteInfo>
+ContractionHierarchyRouter<Weight>::BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const {
+    const size_t vertex_count = ranks_.size();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    stats = {};
+
+    // состояние поиска переиспользуется между запросами потока, сбрасываются только затронутые вершины
+    thread_local SearchSpace forward_space;
+    thread_local SearchSpace backward_space;
+    for (SearchSpace* space : {&forward_space, &backward_space}) {
+        for (const VertexId vertex : space->touched) {
+            space->weights[vertex] = INFINITE_WEIGHT;
+            space->parent_edges[vertex] = NONE;
+        }
+        space->touched.clear();
+        if (space->weights.size() < vertex_count) {
+            space->weights.resize(vertex_count, INFINITE_WEIGHT);
+            space->parent_edges.resize(vertex_count, NONE);
+        }
+    }
+
+    Queue forward_queue;
+    Queue backward_queue;
+    forward_space.weights[from] = ZERO_WEIGHT;
+    forward_space.touched.push_back(from);
+    forward_queue.push({ZERO_WEIGHT, from});
+    backward_space.weights[to] = ZERO_WEIGHT;
+    backward_space.touched.push_back(to);
+    backward_queue.push({ZERO_WEIGHT, to});
+
+    Weight best_weight = INFINITE_WEIGHT;
+    VertexId meeting_vertex = vertex_count;
+    // поиск в направлении прекращается, когда минимум его кучи не меньше лучшего найденного пути
+    while (true) {
+        const bool forward_active = !forward_queue.empty() && forward_queue.top().first < best_weight;
+        const bool backward_active = !backward_queue.empty() && backward_queue.top().first < best_weight;
+        if (!forward_active && !backward_active) {
+            break;
+        }
+        if (forward_active && (!backward_active || forward_queue.top().first <= backward_queue.top().first)) {
+            SettleVertex(forward_queue, forward_space, backward_space, forward_arcs_, best_weight, meeting_vertex,
+                         stats);
+        } else {
+            SettleVertex(backward_queue, backward_space, forward_space, backward_arcs_, best_weight, meeting_vertex,
+                         stats);
+        }
+    }
+
+    if (meeting_vertex == vertex_count) {
+        return std::nullopt;
+    }
+
+    // рёбра иерархии от from до точки встречи и от точки встречи до to
+    std::vector<size_t> forward_edges;
+    for (VertexId vertex = meeting_vertex; forward_space.parent_edges[vertex] != NONE;
+         vertex = ch_edges_[forward_space.parent_edges[vertex]].from) {
+        forward_edges.push_back(forward_space.parent_edges[vertex]);
+    }
+    std::reverse(forward_edges.begin(), forward_edges.end());
+    for (VertexId vertex = meeting_vertex; backward_space.parent_edges[vertex] != NONE;
+         vertex = ch_edges_[backward_space.parent_edges[vertex]].to) {
+        forward_edges.push_back(backward_space.parent_edges[vertex]);
+    }
+
+    std::vector<EdgeId> edges;
+    for (const size_t ch_edge : forward_edges) {
+        UnpackEdge(ch_edge, edges);
+    }
+    return RouteInfo{best_weight, std::move(edges)};
+}
+
+template <typename Weight>
+std::vector<std::optional<Weight>> ContractionHierarchyRouter<Weight>::BuildWeights(
+        const std::vector<VertexId>& from, const std::vector<VertexId>& to) const {
+    const size_t vertex_count = ranks_.size();
+    for (const auto* vertices : {&from, &to}) {
+        for (const VertexId vertex : *vertices) {
+            if (vertex >= vertex_count) {
+                throw std::out_of_range("Vertex id is out of range");
+            }
+        }
+    }
+
+    // корзина вершины: номера целей и веса путей от вершины до них вниз по иерархии
+    std::vector<std::vector<std::pair<size_t, Weight>>> buckets(vertex_count);
+    thread_local SearchSpace space;
+    for (size_t j = 0; j < to.size(); ++j) {
+        SearchUpward(to[j], backward_arcs_, space);
+        for (const VertexId vertex : space.touched) {
+            buckets[vertex].push_back({j, space.weights[vertex]});
+        }
+    }
+
+    std::vector<Weight> best_weights(from.size() * to.size(), INFINITE_WEIGHT);
+    for (size_t i = 0; i < from.size(); ++i) {
+        SearchUpward(from[i], forward_arcs_, space);
+        Weight* row = best_weights.data() + i * to.size();
+        for (const VertexId vertex : space.touched) {
+            for (const auto& [j, weight] : buckets[vertex]) {
+                row[j] = std::min(row[j], space.weights[vertex] + weight);
+            }
+        }
+    }
+
+    std::vector<std::optional<Weight>> weights;
+    weights.reserve(best_weights.size());
+    for (const Weight weight : best_weights) {
+        weights.push_back(weight == INFINITE_WEIGHT ? std::nullopt : std::optional<Weight>(weight));
+    }
+    return weights;
+}
+
+template <typename Weight>
+void ContractionHierarchyRouter<Weight>::SearchUpward(VertexId source, const UpwardArcs& upward,
+                                                      SearchSpace& space) const {
+    const size_t vertex_count = ranks_.size();
+    for (const VertexId vertex : space.touched) {
+        space.weights[vertex] = INFINITE_WEIGHT;
+        space.parent_edges[vertex] = NONE;
+    }
+    space.touched.clear();
+    if (space.weights.size() < vertex_count) {
+        space.weights.resize(vertex_count, INFINITE_WEIGHT);
+        space.parent_edges.resize(vertex_count, NONE);
+    }
+
+    Queue queue;
+    space.weights[source] = ZERO_WEIGHT;
+    space.touched.push_back(source);
+    queue.push({ZERO_WEIGHT, source});
+    while (!queue.empty()) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (weight > space.weights[vertex]) {
+            continue; // устаревший элемент кучи
+        }
+        for (size_t i = upward.offsets[vertex]; i < upward.offsets[vertex + 1]; ++i) {
+            const auto& arc = upward.arcs[i];
+            const Weight candidate_weight = weight + arc.weight;
+            if (candidate_weight < space.weights[arc.other]) {
+                if (space.weights[arc.other] == INFINITE_WEIGHT) {
+                    space.touched.push_back(arc.other);
+                }
+                space.weights[arc.other] = candidate_weight;
+                space.parent_edges[arc.other] = arc.ch_edge;
+                queue.push({candidate_weight, arc.other});
+            }
+        }
+    }
+}
+
+template <typename Weight>
+void ContractionHierarchyRouter<Weight>::UnpackEdge(size_t ch_edge, std::vector<EdgeId>& edges) const {
+    std::vector<size_t> stack = {ch_edge};
+    while (!stack.empty()) {
+        const auto& edge = ch_edges_[stack.back()];
+        const size_t current = stack.back();
+        stack.pop_back();
+        if (edge.first_child == NONE) {
+            edges.push_back(current);
+        } else {
+            stack.push_back(edge.second_child); // первое ребро раскрывается первым
+            stack.push_back(edge.first_child);
+        }
+    }
+}
+
+}  // namespace graph
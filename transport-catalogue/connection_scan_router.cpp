@@ -0,0 +1,96 @@
+#include "connection_scan_router.h"
+
+#include <algorithm>
+#include <tuple>
+
+
+namespace transport_router {
+    using namespace domain;
+
+    ConnectionScanRouter::ConnectionScanRouter(const transport_catalogue::TransportCatalogue& db, SegmentTime segment_time)
+        : db_(db)
+    {
+        // рейс по маршруту route из departure, возвращает время прибытия на конечную
+        const auto add_trip = [&](const Bus& bus, const std::vector<const Stop*>& route, double departure) {
+            const auto trip = static_cast<uint32_t>(trip_buses_.size());
+            trip_buses_.push_back(bus.id);
+            for (size_t i = 0; i + 1 < route.size(); ++i) {
+                const double arrival = departure + segment_time(route[i], route[i + 1]);
+                connections_.push_back({ departure, arrival, route[i]->id, route[i + 1]->id, trip,
+                                         static_cast<uint32_t>(i) });
+                departure = arrival;
+            }
+            return departure;
+        };
+        for (const auto& bus : db_.GetBuses()) {
+            if (bus.route.size() < 2) {
+                continue;
+            }
+            const std::vector<const Stop*> reversed_route(bus.route.rbegin(), bus.route.rend());
+            for (const double departure : bus.departures) {
+                const double arrival = add_trip(bus, bus.route, departure);
+                if (!bus.is_roundtrip) { // прямой маршрут A,B,C: рейс C,B,A отправляется по прибытии на C
+                    add_trip(bus, reversed_route, arrival);
+                }
+            }
+        }
+
+        // связи с равным отправлением: сначала с более ранним прибытием (перегоны нулевой длины), затем по порядку рейса
+        std::sort(connections_.begin(), connections_.end(), [](const Connection& lhs, const Connection& rhs) {
+            return std::tie(lhs.departure, lhs.arrival, lhs.trip, lhs.position)
+                 < std::tie(rhs.departure, rhs.arrival, rhs.trip, rhs.position);
+        });
+    }
+
+    std::optional<RouteInfo> ConnectionScanRouter::FindRoute(const Stop* from, const Stop* to, double departure_time,
+                                                             graph::SearchStats& stats) const {
+        stats = {};
+        const size_t stop_count = db_.GetStops().size();
+        std::vector<double> arrivals(stop_count, INFINITE_TIME);
+        std::vector<Journey> journeys(stop_count);
+        std::vector<uint32_t> trip_boards(trip_buses_.size(), NONE); // связь посадки на рейс
+        arrivals[from->id] = departure_time;
+
+        // связи, отправляющиеся раньше departure_time, недоступны
+        const auto first = std::lower_bound(connections_.begin(), connections_.end(), departure_time,
+            [](const Connection& connection, double time) {
+                return connection.departure < time;
+            });
+        for (auto it = first; it != connections_.end(); ++it) {
+            const Connection& connection = *it;
+            if (arrivals[to->id] <= connection.departure) {
+                break; // дальнейшие связи не прибудут раньше
+            }
+            ++stats.relaxed_edges;
+            const auto index = static_cast<uint32_t>(it - connections_.begin());
+            if (trip_boards[connection.trip] == NONE) {
+                if (arrivals[connection.from] > connection.departure) {
+                    continue; // на рейс не успеть
+                }
+                trip_boards[connection.trip] = index;
+            }
+            if (connection.arrival < arrivals[connection.to]) {
+                arrivals[connection.to] = connection.arrival;
+                journeys[connection.to] = { trip_boards[connection.trip], index };
+                ++stats.settled_vertices;
+            }
+        }
+        if (arrivals[to->id] == INFINITE_TIME) {
+            return std::nullopt;
+        }
+
+        // идём от конца по поездкам: ожидание на остановке посадки - от прибытия на неё до отправления рейса
+        std::vector<EdgeInfo> route_edges;
+        for (uint32_t stop = to->id; stop != from->id;) {
+            const Connection& board = connections_[journeys[stop].board];
+            const Connection& alight = connections_[journeys[stop].alight];
+            route_edges.emplace_back(BusEdgeInfo{ trip_buses_[alight.trip], alight.arrival - board.departure,
+                                                  alight.position - board.position + 1 });
+            stop = board.from;
+            route_edges.emplace_back(WaitEdgeInfo{ stop, board.departure - arrivals[stop] });
+        }
+        std::reverse(route_edges.begin(), route_edges.end());
+        return RouteInfo{ arrivals[to->id] - departure_time, std::move(route_edges) };
+    }
+
+} // namespace transport_router
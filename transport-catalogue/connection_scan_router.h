@@ -0,0 +1,70 @@
+#pragma once
+
+#include "domain.h"
+#include "router.h"
+#include "transport_catalogue.h"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <vector>
+
+
+/*
+поиск маршрутов по расписанию (Connection Scan): рейсы автобусов разбиты на связи - перегоны рейса
+с временем отправления и прибытия, все связи лежат в одном массиве по возрастанию времени отправления.
+Запрос с самым ранним прибытием - один линейный проход по массиву от времени отправления
+*/
+namespace transport_router {
+
+class ConnectionScanRouter {
+public:
+    // время на перегоне между соседними остановками маршрута
+    using SegmentTime = std::function<double(const domain::Stop*, const domain::Stop*)>;
+
+    /*
+    рейсы строятся по расписаниям автобусов справочника: рейс отправляется с первой остановки в момент
+    из departures, прямой маршрут после конечной идёт обратно отдельным рейсом без стоянки
+    */
+    ConnectionScanRouter(const transport_catalogue::TransportCatalogue& db, SegmentTime segment_time);
+
+    /*
+    маршрут с самым ранним прибытием в to при отправлении из from не раньше departure_time:
+    ожидания - фактические до отправления рейсов, время маршрута - от departure_time до прибытия.
+    Счётчики: улучшенные времена прибытия на остановки и просмотренные связи
+    */
+    std::optional<domain::RouteInfo> FindRoute(const domain::Stop* from, const domain::Stop* to,
+                                               double departure_time, graph::SearchStats& stats) const;
+
+    // число связей всех рейсов
+    size_t GetConnectionCount() const {
+        return connections_.size();
+    }
+
+private:
+    static constexpr double INFINITE_TIME = std::numeric_limits<double>::infinity();
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    // перегон рейса: остановки, время отправления и прибытия, рейс и номер перегона в рейсе
+    struct Connection {
+        double departure;
+        double arrival;
+        uint32_t from;
+        uint32_t to;
+        uint32_t trip;
+        uint32_t position;
+    };
+
+    // поездка, которой достигнута остановка: связь посадки и связь высадки
+    struct Journey {
+        uint32_t board = NONE;
+        uint32_t alight = NONE;
+    };
+
+    const transport_catalogue::TransportCatalogue& db_;
+    std::vector<Connection> connections_; // по возрастанию времени отправления
+    std::vector<domain::BusId> trip_buses_; // номер рейса - автобус
+};
+
+} // namespace transport_router
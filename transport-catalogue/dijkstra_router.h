@@ -0,0 +1,325 @@
+#pragma once
+
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+// поиск кратчайшего пути по запросу (алгоритм Дейкстры с двоичной кучей и его целенаправленный вариант A*)
+namespace graph {
+
+/*
+маршрутизатор без предрасчёта: построение O(E) на проверку весов,
+память линейна по размеру графа, каждый BuildRoute - отдельный поиск O((V + E) log V)
+*/
+template <typename Weight>
+class DijkstraRouter : public RouterBase<Weight> {
+protected:
+    using Graph = CompactGraph<Weight>;
+
+    // нижняя оценка веса пути от вершины до цели (vertex, target)
+    using Heuristic = std::function<Weight(VertexId, VertexId)>;
+
+    // с эвристикой поиск становится A*: ключ кучи - вес от начала плюс оценка до цели
+    DijkstraRouter(const Graph& graph, Heuristic heuristic);
+
+public:
+    using typename RouterBase<Weight>::RouteInfo;
+
+    explicit DijkstraRouter(const Graph& graph);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    std::optional<RouteInfo> BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const override;
+
+    // один поиск из from до просмотра всех вершин to, маршруты восстанавливаются по общему дереву предков
+    std::vector<std::optional<RouteInfo>> BuildRoutes(VertexId from, const std::vector<VertexId>& to) const override;
+
+    // по одному поиску из каждой вершины from
+    std::vector<std::optional<Weight>> BuildWeights(const std::vector<VertexId>& from,
+                                                    const std::vector<VertexId>& to) const override;
+
+private:
+    // элемент кучи: ключ (вес или вес с оценкой) и вершина
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    // дерево поиска из одной вершины: веса, последние рёбра маршрутов и просмотренные вершины
+    struct SearchTree {
+        std::vector<std::optional<Weight>> weights;
+        std::vector<std::optional<EdgeId>> prev_edges;
+        std::vector<bool> settled;
+    };
+
+    // поиск Дейкстры из from до просмотра всех вершин to
+    SearchTree SearchToTargets(VertexId from, const std::vector<VertexId>& to) const;
+
+    // восстанавливает маршрут до to по последним рёбрам маршрутов
+    std::vector<EdgeId> BuildEdges(const std::vector<std::optional<EdgeId>>& prev_edges, VertexId to) const;
+
+    static constexpr Weight ZERO_WEIGHT{};
+    const Graph& graph_;
+    Heuristic heuristic_;
+};
+
+/*
+A*: эвристика должна быть согласованной (h(u) <= w(u, v) + h(v), h(to) = 0),
+тогда каждая вершина просматривается один раз и найденный путь оптимален
+*/
+template <typename Weight>
+class AStarRouter : public DijkstraRouter<Weight> {
+public:
+    using typename DijkstraRouter<Weight>::Graph;
+    using typename DijkstraRouter<Weight>::Heuristic;
+
+    AStarRouter(const Graph& graph, Heuristic heuristic)
+        : DijkstraRouter<Weight>(graph, std::move(heuristic)) {
+    }
+};
+
+/*
+вершины, достижимые из from с весом пути не больше budget, в порядке просмотра (по неубыванию веса).
+Поиск останавливается, как только ключ кучи превышает budget; рабочие массивы переиспользуются между вызовами потока
+*/
+template <typename Weight>
+std::vector<std::pair<VertexId, Weight>> SearchWithinBudget(const CompactGraph<Weight>& graph, VertexId from,
+                                                            Weight budget) {
+    const size_t vertex_count = graph.GetVertexCount();
+    if (from >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    // состояние поиска: сбрасываются только вершины, затронутые прошлым вызовом
+    struct SearchSpace {
+        std::vector<Weight> weights;
+        std::vector<bool> reached;
+        std::vector<VertexId> touched;
+    };
+    thread_local SearchSpace space;
+    for (const VertexId vertex : space.touched) {
+        space.reached[vertex] = false;
+    }
+    space.touched.clear();
+    if (space.reached.size() < vertex_count) {
+        space.weights.resize(vertex_count);
+        space.reached.resize(vertex_count, false);
+    }
+
+    using QueueItem = std::pair<Weight, VertexId>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    std::vector<std::pair<VertexId, Weight>> settled;
+    space.weights[from] = Weight{};
+    space.reached[from] = true;
+    space.touched.push_back(from);
+    queue.push({Weight{}, from});
+
+    while (!queue.empty() && !(budget < queue.top().first)) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (space.weights[vertex] < weight) {
+            continue; // устаревший элемент кучи
+        }
+        settled.push_back({vertex, weight});
+        for (const auto& arc : graph.GetArcs(vertex)) {
+            const Weight candidate_weight = weight + arc.weight;
+            if (budget < candidate_weight) {
+                continue;
+            }
+            if (!space.reached[arc.to]) {
+                space.reached[arc.to] = true;
+                space.touched.push_back(arc.to);
+            } else if (!(candidate_weight < space.weights[arc.to])) {
+                continue;
+            }
+            space.weights[arc.to] = candidate_weight;
+            queue.push({candidate_weight, arc.to});
+        }
+    }
+    return settled;
+}
+
+template <typename Weight>
+DijkstraRouter<Weight>::DijkstraRouter(const Graph& graph)
+    : DijkstraRouter(graph, nullptr) {
+}
+
+template <typename Weight>
+DijkstraRouter<Weight>::DijkstraRouter(const Graph& graph, Heuristic heuristic)
+    : graph_(graph)
+    , heuristic_(std::move(heuristic))
+{
+    for (VertexId vertex = 0; vertex < graph.GetVertexCount(); ++vertex) {
+        for (const auto& arc : graph.GetArcs(vertex)) {
+            if (arc.weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<typename DijkstraRouter<Weight>::RouteInfo> DijkstraRouter<Weight>::BuildRoute(VertexId from,
+                                                                                             VertexId to) const {
+    SearchStats stats;
+    return BuildRouteWithStats(from, to, stats);
+}
+
+template <typename Weight>
+std::optional<typename DijkstraRouter<Weight>::RouteInfo>
+DijkstraRouter<Weight>::BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    stats = {};
+
+    std::vector<std::optional<Weight>> weights(vertex_count);
+    std::vector<std::optional<EdgeId>> prev_edges(vertex_count);
+    std::vector<bool> settled(vertex_count, false);
+
+    // оценка до цели вычисляется один раз для каждой достигнутой вершины
+    std::vector<std::optional<Weight>> estimates(heuristic_ ? vertex_count : 0);
+    const auto estimate = [&](VertexId vertex) {
+        if (!heuristic_) {
+            return ZERO_WEIGHT;
+        }
+        if (!estimates[vertex]) {
+            estimates[vertex] = heuristic_(vertex, to);
+        }
+        return *estimates[vertex];
+    };
+
+    Queue queue;
+    weights[from] = ZERO_WEIGHT;
+    queue.push({estimate(from), from});
+
+    while (!queue.empty()) {
+        const VertexId vertex = queue.top().second;
+        queue.pop();
+        if (settled[vertex]) {
+            continue; // устаревший элемент кучи
+        }
+        settled[vertex] = true;
+        ++stats.settled_vertices;
+        if (vertex == to) {
+            break;
+        }
+        const Weight weight = *weights[vertex];
+        for (const auto& arc : graph_.GetArcs(vertex)) {
+            const Weight candidate_weight = weight + arc.weight;
+            ++stats.relaxed_edges;
+            if (!weights[arc.to] || candidate_weight < *weights[arc.to]) {
+                weights[arc.to] = candidate_weight;
+                prev_edges[arc.to] = arc.edge_id;
+                queue.push({candidate_weight + estimate(arc.to), arc.to});
+            }
+        }
+    }
+
+    if (!settled[to]) {
+        return std::nullopt;
+    }
+    return RouteInfo{*weights[to], BuildEdges(prev_edges, to)};
+}
+
+template <typename Weight>
+std::vector<std::optional<typename DijkstraRouter<Weight>::RouteInfo>>
+DijkstraRouter<Weight>::BuildRoutes(VertexId from, const std::vector<VertexId>& to) const {
+    const SearchTree tree = SearchToTargets(from, to);
+    std::vector<std::optional<RouteInfo>> routes;
+    routes.reserve(to.size());
+    for (const VertexId vertex : to) {
+        if (tree.settled[vertex]) {
+            routes.push_back(RouteInfo{*tree.weights[vertex], BuildEdges(tree.prev_edges, vertex)});
+        } else {
+            routes.push_back(std::nullopt);
+        }
+    }
+    return routes;
+}
+
+template <typename Weight>
+std::vector<std::optional<Weight>> DijkstraRouter<Weight>::BuildWeights(const std::vector<VertexId>& from,
+                                                                        const std::vector<VertexId>& to) const {
+    std::vector<std::optional<Weight>> weights;
+    weights.reserve(from.size() * to.size());
+    for (const VertexId vertex_from : from) {
+        const SearchTree tree = SearchToTargets(vertex_from, to);
+        for (const VertexId vertex_to : to) {
+            weights.push_back(tree.settled[vertex_to] ? tree.weights[vertex_to] : std::nullopt);
+        }
+    }
+    return weights;
+}
+
+template <typename Weight>
+typename DijkstraRouter<Weight>::SearchTree DijkstraRouter<Weight>::SearchToTargets(VertexId from,
+                                                                                    const std::vector<VertexId>& to) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    // вершины назначения, ещё не просмотренные поиском (с учётом повторов)
+    std::vector<size_t> target_counts(vertex_count, 0);
+    size_t targets_left = 0;
+    for (const VertexId vertex : to) {
+        if (target_counts.at(vertex)++ == 0) {
+            ++targets_left;
+        }
+    }
+
+    // эвристика A* годится только для одной цели, поэтому здесь обычный поиск Дейкстры
+    SearchTree tree{std::vector<std::optional<Weight>>(vertex_count),
+                    std::vector<std::optional<EdgeId>>(vertex_count),
+                    std::vector<bool>(vertex_count, false)};
+    auto& [weights, prev_edges, settled] = tree;
+
+    Queue queue;
+    weights[from] = ZERO_WEIGHT;
+    queue.push({ZERO_WEIGHT, from});
+
+    while (!queue.empty() && targets_left > 0) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (settled[vertex]) {
+            continue; // устаревший элемент кучи
+        }
+        settled[vertex] = true;
+        if (target_counts[vertex] > 0) {
+            --targets_left;
+        }
+        for (const auto& arc : graph_.GetArcs(vertex)) {
+            const Weight candidate_weight = weight + arc.weight;
+            if (!weights[arc.to] || candidate_weight < *weights[arc.to]) {
+                weights[arc.to] = candidate_weight;
+                prev_edges[arc.to] = arc.edge_id;
+                queue.push({candidate_weight, arc.to});
+            }
+        }
+    }
+    return tree;
+}
+
+template <typename Weight>
+std::vector<EdgeId> DijkstraRouter<Weight>::BuildEdges(const std::vector<std::optional<EdgeId>>& prev_edges,
+                                                       VertexId to) const {
+    std::vector<EdgeId> edges;
+    for (std::optional<EdgeId> edge_id = prev_edges[to];
+         edge_id;
+         edge_id = prev_edges[graph_.GetEdge(*edge_id).from])
+    {
+        edges.push_back(*edge_id);
+    }
+    std::reverse(edges.begin(), edges.end());
+    return edges;
+}
+
+}  // namespace graph
@@ -2,6 +2,7 @@
 
 #include "geo.h"
 
+#include <cstdint>
 #include <optional>
 #include <variant>
 #include <vector>
@@ -11,10 +12,15 @@
 // классы основных сущностей, описывают автобусы и остановки
 namespace domain {
 
-// остановка: название и координаты
+// номера остановок и автобусов в справочнике (в порядке добавления)
+using StopId = uint32_t;
+using BusId = uint32_t;
+
+// остановка: название, координаты и номер (назначается справочником)
 struct Stop {
     std::string name; 
     geo::Coordinates coordinates;
+    StopId id = 0;
 };
 
 /*
@@ -25,6 +31,8 @@ struct Bus {
     bool is_roundtrip; 
     std::string name; 
     std::vector<const Stop*> route; // остановки на маршруте автобуса
+    BusId id = 0; // номер автобуса (назначается справочником)
+    std::vector<double> departures = {}; // расписание: отправления рейсов с первой остановки, минуты от начала суток
 };
 
 /*
@@ -49,14 +57,14 @@ struct StopInfo {
 
 // информация о ребре движения (звено маршрута от остановки до остановки на автобусе)
 struct BusEdgeInfo {
-    std::string name; // название маршрута 
+    BusId bus; // номер автобуса, название - TransportCatalogue::GetBusName
     double time;
-    size_t span_count = 0;
+    uint32_t span_count = 0;
 };
 
 // информация о ребре ожидания (звено маршрута - пересадка на остановке)
 struct WaitEdgeInfo {
-    std::string name; // название остановки
+    StopId stop; // номер остановки, название - TransportCatalogue::GetStopName
     double time;
 };
 
@@ -69,10 +77,81 @@ struct RouteInfo {
     std::vector<EdgeInfo> route_edges;
 };
 
+// остановка, достижимая за отведённое время, и время маршрута до неё
+struct ReachableStop {
+    std::string name;
+    double time = 0.0;
+};
+
+// ответ на запрос Isochrone: достижимые остановки по возрастанию времени и карта с ними (если запрошена)
+struct IsochroneInfo {
+    std::vector<ReachableStop> stops;
+    std::string map;
+};
+
+// время маршрутов всех пар: [i][j] - от i-й остановки отправления до j-й остановки прибытия, nullopt - маршрута нет
+using TravelTimes = std::vector<std::vector<std::optional<double>>>;
+
+/*
+тип маршрутизатора:
+ALL_PAIRS - предрасчёт всех пар вершин (мгновенный ответ, O(V^2) памяти),
+DIJKSTRA - поиск по запросу (быстрое построение, линейная память),
+CONTRACTION_HIERARCHY - иерархия сжатия (предрасчёт близок к линейному, быстрый двунаправленный поиск),
+ASTAR - поиск по запросу A* с оценкой по географическому расстоянию до остановки назначения,
+RAPTOR - поиск по раундам прямо по маршрутам справочника без графа (поддерживает ограничение пересадок),
+HUB_LABELS - метки-хабы (долгий предрасчёт, запрос - слияние двух коротких массивов),
+ALL_PAIRS_COMPACT - предрасчёт всех пар с таблицей только последних рёбер маршрутов (2 или 4 байта на пару
+вместо 16, вес маршрута складывается по рёбрам при ответе)
+*/
+enum class RouterType {
+    ALL_PAIRS,
+    DIJKSTRA,
+    CONTRACTION_HIERARCHY,
+    ASTAR,
+    RAPTOR,
+    HUB_LABELS,
+    ALL_PAIRS_COMPACT
+};
+
+/*
+модель графа маршрутов:
+STOP_PAIRS - ребро от каждой остановки до каждой следующей на маршруте (k(k-1)/2 рёбер на маршрут из k остановок),
+ROUTE_PATTERNS - цепочка вершин движения на автобусе по остановкам маршрута с рёбрами посадки и высадки
+(число рёбер линейно по длине маршрута)
+*/
+enum class GraphModel {
+    STOP_PAIRS,
+    ROUTE_PATTERNS
+};
+
+/*
+нумерация вершин остановок в графе:
+CATALOGUE - в порядке добавления остановок в справочник,
+HILBERT - по кривой Гильберта над координатами остановок: соседние остановки получают близкие номера,
+и строки таблиц и массивы поиска для них лежат рядом в памяти
+*/
+enum class VertexOrder {
+    CATALOGUE,
+    HILBERT
+};
+
 // настройки маршрутизации
 struct RouterSettings {
     double bus_wait_time_ = 0.0;
     double bus_velocity_ = 0.0;
+    RouterType router_type_ = RouterType::ALL_PAIRS;
+    size_t router_threads_ = 1; // потоков для построения таблицы всех пар, 0 - по числу ядер
+    GraphModel graph_model_ = GraphModel::STOP_PAIRS;
+    // наибольшее число пересадок, по умолчанию без ограничения: ограничивает раунды RAPTOR
+    // и число поездок маршрутов запроса ParetoRoute у всех маршрутизаторов
+    std::optional<size_t> max_transfers_;
+    size_t route_cache_capacity_ = 0; // ёмкость кэша готовых маршрутов (пар остановок), 0 - без кэша
+    VertexOrder vertex_order_ = VertexOrder::CATALOGUE;
+};
+
+// настройки сохранения маршрутизатора: путь к двоичному файлу (пустой - без сохранения)
+struct SerializationSettings {
+    std::string file;
 };
 
 struct Hasher {
@@ -93,6 +172,7 @@ struct BusBaseRequest {
     std::string name;
     std::vector<std::string> stops; 
     bool is_roundtrip;
+    std::vector<double> departures = {}; // отправления рейсов с первой остановки (минуты от начала суток), пусто - без расписания
 };
 
 /*
@@ -116,22 +196,34 @@ struct StatRequest {
     std::string name; 
     std::string from; 
     std::string to; 
+    std::vector<std::string> origins; // остановки отправления запроса Matrix
+    std::vector<std::string> destinations; // остановки прибытия запроса Matrix
+    double time_budget = 0.0; // время на дорогу в минутах для запроса Isochrone
+    bool render_map = false; // нарисовать карту с достижимыми остановками для запроса Isochrone
+    std::optional<double> departure_time = std::nullopt; // время отправления (минуты от начала суток) для запроса Route по расписанию
+    size_t route_count = 3; // число маршрутов для запроса RouteAlternatives, 0 - запрос некорректен
 };
 
 /*
 Для вектора результатов запросов на вывод:
-пара id запроса - BusInfo/StopInfo/std::string,
-для запросов Bus, Stop, Map соответственно
+пара id запроса - BusInfo/StopInfo/std::string/RouteInfo/TravelTimes/IsochroneInfo/вектор RouteInfo,
+для запросов Bus, Stop, Map, Route, Matrix, Isochrone, ParetoRoute и RouteAlternatives соответственно
 */
 using StatResultBus = std::pair<int, std::optional<BusInfo>>;
 using StatResultStop = std::pair<int, std::optional<StopInfo>>;
 using StatResultMap = std::pair<int, std::string>;
 using StatResultRoute = std::pair<int, std::optional<RouteInfo>>;
+using StatResultMatrix = std::pair<int, TravelTimes>;
+using StatResultIsochrone = std::pair<int, std::optional<IsochroneInfo>>;
+using StatResultRoutes = std::pair<int, std::optional<std::vector<RouteInfo>>>;
 
 using StatResult = std::variant<std::nullptr_t,
                                 StatResultBus,
                                 StatResultStop,
                                 StatResultMap,
-                                StatResultRoute>;
+                                StatResultRoute,
+                                StatResultMatrix,
+                                StatResultIsochrone,
+                                StatResultRoutes>;
 
 } //namespace domain
\ No newline at end of file
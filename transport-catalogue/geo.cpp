@@ -1,6 +1,9 @@
 #define _USE_MATH_DEFINES
 #include "geo.h"
 
+#include <algorithm>
+#include <utility>
+
 
 namespace geo {
     using namespace std::literals;
@@ -10,4 +13,33 @@ namespace geo {
             return out;
         }
 
+    uint64_t ComputeHilbertIndex(Coordinates point, Coordinates min, Coordinates max) {
+        static constexpr uint32_t GRID_SIZE = 1u << 16;
+        const auto to_cell = [](double value, double min_value, double max_value) {
+            if (!(max_value > min_value)) { // вырожденный по этой оси прямоугольник
+                return 0u;
+            }
+            const double cell = (value - min_value) / (max_value - min_value) * (GRID_SIZE - 1);
+            return static_cast<uint32_t>(std::clamp(cell, 0.0, static_cast<double>(GRID_SIZE - 1)));
+        };
+        uint32_t x = to_cell(point.lng, min.lng, max.lng);
+        uint32_t y = to_cell(point.lat, min.lat, max.lat);
+
+        // спуск по четвертям от крупной к мелкой с поворотом квадранта
+        uint64_t index = 0;
+        for (uint32_t half = GRID_SIZE / 2; half > 0; half /= 2) {
+            const uint32_t rx = (x & half) != 0 ? 1 : 0;
+            const uint32_t ry = (y & half) != 0 ? 1 : 0;
+            index += static_cast<uint64_t>(half) * half * ((3 * rx) ^ ry);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = GRID_SIZE - 1 - x;
+                    y = GRID_SIZE - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return index;
+    }
+
 }  // namespace geo
\ No newline at end of file
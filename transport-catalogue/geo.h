@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 
 
@@ -34,4 +35,10 @@ inline double ComputeDistance(Coordinates from, Coordinates to) {
         * EarthRadius;
 }
 
+/*
+номер точки на кривой Гильберта по сетке 2^16 x 2^16, натянутой на прямоугольник min - max:
+близкие номера у близких точек, поэтому сортировка по номеру сохраняет географическую близость
+*/
+uint64_t ComputeHilbertIndex(Coordinates point, Coordinates min, Coordinates max);
+
 } //namespace geo
\ No newline at end of file
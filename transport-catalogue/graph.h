@@ -2,7 +2,11 @@
 
 #include "ranges.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 
 
@@ -40,6 +44,74 @@ private:
     std::vector<IncidenceList> incidence_lists_;
 };
 
+/*
+удаляет доминируемые параллельные рёбра: из рёбер с общими началом и концом остаётся одно наименьшего веса,
+при равных весах - с наименьшим id, поэтому кратчайшие пути и выбор среди равных путей не меняются.
+Оставшиеся рёбра сохраняют порядок id; kept_edges[новый id] - id ребра в исходном графе
+*/
+template <typename Weight>
+DirectedWeightedGraph<Weight> PruneDominatedEdges(const DirectedWeightedGraph<Weight>& graph,
+                                                  std::vector<EdgeId>& kept_edges);
+
+/*
+граф в сжатом построчном формате (CSR): исходящие дуги всех вершин лежат подряд в одном массиве,
+дуги вершины v занимают [offsets_[v], offsets_[v + 1]) в порядке id рёбер, как в списках смежности исходного графа.
+Строится из DirectedWeightedGraph после добавления всех рёбер, обход дуг вершины идёт по памяти последовательно.
+Удаление и добавление рёбер пересобирает массивы целиком за O(V + E)
+*/
+template <typename Weight>
+class CompactGraph {
+public:
+    // исходящая дуга: конец, id ребра исходного графа и вес
+    struct Arc {
+        uint32_t to;
+        uint32_t edge_id;
+        Weight weight;
+    };
+
+private:
+    using ArcsRange = ranges::Range<typename std::vector<Arc>::const_iterator>;
+
+public:
+    CompactGraph() = default;
+    explicit CompactGraph(const DirectedWeightedGraph<Weight>& graph);
+
+    size_t GetVertexCount() const;
+    size_t GetEdgeCount() const;
+
+    // ребро по id, начало ребра находится двоичным поиском по смещениям вершин
+    Edge<Weight> GetEdge(EdgeId edge_id) const;
+
+    ArcsRange GetArcs(VertexId vertex) const;
+
+    // меняет вес ребра на месте, структура графа не меняется
+    void SetEdgeWeight(EdgeId edge_id, Weight weight);
+
+    // id удалённого ребра в результате RemoveEdges
+    static constexpr EdgeId REMOVED_EDGE = std::numeric_limits<EdgeId>::max();
+
+    /*
+    удаляет рёбра с is_removed[id]; остальные рёбра сохраняют порядок, их id сдвигаются.
+    Возвращает новый id каждого прежнего ребра или REMOVED_EDGE
+    */
+    std::vector<EdgeId> RemoveEdges(const std::vector<bool>& is_removed);
+
+    // добавляет вершины до graph.GetVertexCount() и рёбра graph с id после имеющихся в порядке их id в graph
+    void AddEdges(const DirectedWeightedGraph<Weight>& graph);
+
+private:
+    // заполняет массивы рёбрами get_edge(0) .. get_edge(edge_count - 1)
+    template <typename GetEdgeFunc>
+    void Assign(size_t vertex_count, size_t edge_count, const GetEdgeFunc& get_edge);
+
+    // все рёбра по порядку id
+    std::vector<Edge<Weight>> GetEdges() const;
+
+    std::vector<uint32_t> offsets_; // начало дуг каждой вершины, последний элемент - число дуг
+    std::vector<Arc> arcs_;
+    std::vector<uint32_t> arc_positions_; // id ребра - позиция его дуги в arcs_
+};
+
 template <typename Weight>
 DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
     : incidence_lists_(vertex_count) {
@@ -73,4 +145,153 @@ typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
 DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
     return ranges::AsRange(incidence_lists_.at(vertex));
 }
+template <typename Weight>
+DirectedWeightedGraph<Weight> PruneDominatedEdges(const DirectedWeightedGraph<Weight>& graph,
+                                                  std::vector<EdgeId>& kept_edges) {
+    constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+    const size_t vertex_count = graph.GetVertexCount();
+
+    // лучшее ребро в каждый конец из текущей вершины; сбрасываются только затронутые концы
+    std::vector<EdgeId> best_edges(vertex_count, NO_EDGE);
+    std::vector<VertexId> touched;
+    std::vector<bool> is_kept(graph.GetEdgeCount(), false);
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+            const auto& edge = graph.GetEdge(edge_id);
+            EdgeId& best_edge = best_edges[edge.to];
+            if (best_edge == NO_EDGE) {
+                touched.push_back(edge.to);
+                best_edge = edge_id;
+            } else if (edge.weight < graph.GetEdge(best_edge).weight) {
+                best_edge = edge_id; // рёбра идут по возрастанию id, поэтому при равенстве остаётся прежнее
+            }
+        }
+        for (const VertexId to : touched) {
+            is_kept[best_edges[to]] = true;
+            best_edges[to] = NO_EDGE;
+        }
+        touched.clear();
+    }
+
+    DirectedWeightedGraph<Weight> pruned_graph(vertex_count);
+    kept_edges.clear();
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (is_kept[edge_id]) {
+            pruned_graph.AddEdge(graph.GetEdge(edge_id));
+            kept_edges.push_back(edge_id);
+        }
+    }
+    return pruned_graph;
+}
+
+template <typename Weight>
+CompactGraph<Weight>::CompactGraph(const DirectedWeightedGraph<Weight>& graph) {
+    Assign(graph.GetVertexCount(), graph.GetEdgeCount(), [&graph](EdgeId edge_id) -> const Edge<Weight>& {
+        return graph.GetEdge(edge_id);
+    });
+}
+
+template <typename Weight>
+template <typename GetEdgeFunc>
+void CompactGraph<Weight>::Assign(size_t vertex_count, size_t edge_count, const GetEdgeFunc& get_edge) {
+    if (vertex_count >= std::numeric_limits<uint32_t>::max() || edge_count >= std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Graph is too large for compact form");
+    }
+
+    // сортировка подсчётом по началу ребра сохраняет порядок id внутри вершины
+    offsets_.assign(vertex_count + 1, 0);
+    for (EdgeId edge_id = 0; edge_id < edge_count; ++edge_id) {
+        ++offsets_[get_edge(edge_id).from + 1];
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        offsets_[vertex + 1] += offsets_[vertex];
+    }
+
+    std::vector<uint32_t> next_positions(offsets_.begin(), offsets_.end() - 1);
+    arcs_.resize(edge_count);
+    arc_positions_.resize(edge_count);
+    for (EdgeId edge_id = 0; edge_id < edge_count; ++edge_id) {
+        const auto& edge = get_edge(edge_id);
+        const uint32_t position = next_positions[edge.from]++;
+        arcs_[position] = {static_cast<uint32_t>(edge.to), static_cast<uint32_t>(edge_id), edge.weight};
+        arc_positions_[edge_id] = position;
+    }
+}
+
+template <typename Weight>
+size_t CompactGraph<Weight>::GetVertexCount() const {
+    return offsets_.empty() ? 0 : offsets_.size() - 1;
+}
+
+template <typename Weight>
+size_t CompactGraph<Weight>::GetEdgeCount() const {
+    return arcs_.size();
+}
+
+template <typename Weight>
+Edge<Weight> CompactGraph<Weight>::GetEdge(EdgeId edge_id) const {
+    const uint32_t position = arc_positions_.at(edge_id);
+    const auto it = std::upper_bound(offsets_.begin(), offsets_.end(), position);
+    const auto& arc = arcs_[position];
+    return {static_cast<VertexId>(it - offsets_.begin() - 1), arc.to, arc.weight};
+}
+
+template <typename Weight>
+typename CompactGraph<Weight>::ArcsRange CompactGraph<Weight>::GetArcs(VertexId vertex) const {
+    if (vertex + 1 >= offsets_.size()) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    return ArcsRange{arcs_.begin() + offsets_[vertex], arcs_.begin() + offsets_[vertex + 1]};
+}
+
+template <typename Weight>
+void CompactGraph<Weight>::SetEdgeWeight(EdgeId edge_id, Weight weight) {
+    arcs_[arc_positions_.at(edge_id)].weight = weight;
+}
+
+template <typename Weight>
+std::vector<EdgeId> CompactGraph<Weight>::RemoveEdges(const std::vector<bool>& is_removed) {
+    std::vector<Edge<Weight>> edges = GetEdges();
+    std::vector<EdgeId> edge_ids(edges.size(), REMOVED_EDGE);
+    size_t kept_count = 0;
+    for (EdgeId edge_id = 0; edge_id < edges.size(); ++edge_id) {
+        if (!is_removed.at(edge_id)) {
+            edge_ids[edge_id] = kept_count;
+            edges[kept_count++] = edges[edge_id];
+        }
+    }
+    edges.resize(kept_count);
+    Assign(GetVertexCount(), edges.size(), [&edges](EdgeId edge_id) -> const Edge<Weight>& {
+        return edges[edge_id];
+    });
+    return edge_ids;
+}
+
+template <typename Weight>
+void CompactGraph<Weight>::AddEdges(const DirectedWeightedGraph<Weight>& graph) {
+    if (graph.GetVertexCount() < GetVertexCount()) {
+        throw std::invalid_argument("Added graph has fewer vertices");
+    }
+    std::vector<Edge<Weight>> edges = GetEdges();
+    edges.reserve(edges.size() + graph.GetEdgeCount());
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        edges.push_back(graph.GetEdge(edge_id));
+    }
+    Assign(graph.GetVertexCount(), edges.size(), [&edges](EdgeId edge_id) -> const Edge<Weight>& {
+        return edges[edge_id];
+    });
+}
+
+template <typename Weight>
+std::vector<Edge<Weight>> CompactGraph<Weight>::GetEdges() const {
+    std::vector<Edge<Weight>> edges(arcs_.size());
+    for (VertexId vertex = 0; vertex < GetVertexCount(); ++vertex) {
+        for (uint32_t position = offsets_[vertex]; position < offsets_[vertex + 1]; ++position) {
+            const auto& arc = arcs_[position];
+            edges[arc.edge_id] = {vertex, arc.to, arc.weight};
+        }
+    }
+    return edges;
+}
+
 }  // namespace graph
\ No newline at end of file
@@ -0,0 +1,423 @@
+#pragma once
+
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// поиск кратчайшего пути по меткам-хабам (Hub Labeling)
+namespace graph {
+
+/*
+маршрутизатор с предрасчётом меток: для каждой вершины v хранятся исходящая метка (хабы, достижимые из v,
+с весами пути v -> хаб) и входящая метка (хабы, из которых достижима v, с весами пути хаб -> v).
+Метки строятся усечённым поиском из хабов по убыванию важности (Pruned Landmark Labeling)
+и упорядочены по рангу хаба, поэтому запрос - слияние двух отсортированных массивов.
+Каждый элемент метки хранит ребро пути к хабу, по цепочке этих рёбер путь раскрывается без поиска
+*/
+template <typename Weight>
+class HubLabelRouter : public RouterBase<Weight> {
+private:
+    using Graph = CompactGraph<Weight>;
+
+public:
+    using typename RouterBase<Weight>::RouteInfo;
+
+    // элемент метки: ранг хаба, ребро пути (первое к хабу в исходящей метке, последнее от хаба во входящей) и вес
+    struct LabelEntry {
+        uint32_t hub;
+        uint32_t edge_id;
+        Weight weight;
+    };
+
+    // размеры меток
+    struct LabelStats {
+        size_t total_entries = 0; // элементов в исходящих и входящих метках
+        double average_entries = 0.0; // в среднем на вершину (обе метки)
+        size_t max_entries = 0; // наибольшая метка
+        size_t memory_bytes = 0; // объём массивов меток
+    };
+
+    explicit HubLabelRouter(const Graph& graph);
+
+    // маршрутизатор по готовым меткам (например, отображённым в память из файла), метки не копируются
+    HubLabelRouter(const Graph& graph, const uint32_t* hub_vertices,
+                   const uint32_t* out_offsets, const LabelEntry* out_labels,
+                   const uint32_t* in_offsets, const LabelEntry* in_labels);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    // счётчик просмотренных вершин - число сравнённых элементов меток
+    std::optional<RouteInfo> BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const override;
+
+    // веса всех пар слиянием меток, без восстановления маршрутов
+    std::vector<std::optional<Weight>> BuildWeights(const std::vector<VertexId>& from,
+                                                    const std::vector<VertexId>& to) const override;
+
+    // хабы и рёбра меток при равномерном масштабировании не меняются; внешние метки не масштабируются
+    bool ScaleWeights(double factor) override {
+        if (!std::is_floating_point_v<Weight> || out_labels_data_ != out_labels_.data()) {
+            return false;
+        }
+        for (std::vector<LabelEntry>* labels : { &out_labels_, &in_labels_ }) {
+            for (LabelEntry& entry : *labels) {
+                entry.weight = static_cast<Weight>(entry.weight * factor);
+            }
+        }
+        return true;
+    }
+
+    LabelStats GetLabelStats() const;
+
+    // массивы меток для сохранения: вершины хабов по рангу (GetVertexCount()), смещения меток (GetVertexCount() + 1)
+    // и элементы меток (последнее смещение)
+    size_t GetVertexCount() const {
+        return vertex_count_;
+    }
+    const uint32_t* GetHubVertices() const {
+        return hub_vertices_data_;
+    }
+    const uint32_t* GetOutOffsets() const {
+        return out_offsets_data_;
+    }
+    const LabelEntry* GetOutLabels() const {
+        return out_labels_data_;
+    }
+    const uint32_t* GetInOffsets() const {
+        return in_offsets_data_;
+    }
+    const LabelEntry* GetInLabels() const {
+        return in_labels_data_;
+    }
+
+private:
+    static constexpr uint32_t NO_EDGE = std::numeric_limits<uint32_t>::max();
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr Weight INFINITE_WEIGHT = std::numeric_limits<Weight>::max();
+
+    // дуга обратного списка смежности: начало ребра, id ребра и вес
+    struct InArc {
+        uint32_t from;
+        uint32_t edge_id;
+        Weight weight;
+    };
+
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    // метки на время построения: элементы каждой вершины отдельно
+    using BuildLabels = std::vector<std::vector<LabelEntry>>;
+
+    // усечённый поиск из хаба ранга rank; forward - по рёбрам (входящие метки), иначе против рёбер (исходящие метки)
+    void PrunedSearch(VertexId hub, uint32_t rank, bool forward, const std::vector<std::vector<InArc>>& in_arcs,
+                      BuildLabels& out_labels, BuildLabels& in_labels);
+
+    // собирает метки вершин в общие массивы со смещениями
+    static void FlattenLabels(const BuildLabels& labels, std::vector<uint32_t>& offsets, std::vector<LabelEntry>& entries);
+
+    // слияние исходящей метки from и входящей метки to: вес лучшего пути и ранг его хаба
+    Weight MergeLabels(VertexId from, VertexId to, uint32_t& best_hub, SearchStats& stats) const;
+
+    // элемент метки вершины с хабом ранга hub (метки упорядочены по рангу)
+    static const LabelEntry& FindEntry(const LabelEntry* begin, const LabelEntry* end, uint32_t hub);
+
+    const Graph& graph_;
+    size_t vertex_count_;
+    std::vector<uint32_t> hub_vertices_; // ранг - вершина хаба
+    std::vector<uint32_t> out_offsets_;
+    std::vector<LabelEntry> out_labels_;
+    std::vector<uint32_t> in_offsets_;
+    std::vector<LabelEntry> in_labels_;
+
+    // собственные или внешние массивы меток
+    const uint32_t* hub_vertices_data_ = nullptr;
+    const uint32_t* out_offsets_data_ = nullptr;
+    const LabelEntry* out_labels_data_ = nullptr;
+    const uint32_t* in_offsets_data_ = nullptr;
+    const LabelEntry* in_labels_data_ = nullptr;
+
+    // веса и рёбра поиска из хаба, веса метки хаба по рангам; нужны только при построении
+    std::vector<Weight> search_weights_;
+    std::vector<uint32_t> search_edges_;
+    std::vector<Weight> hub_weights_;
+};
+
+template <typename Weight>
+HubLabelRouter<Weight>::HubLabelRouter(const Graph& graph)
+    : graph_(graph)
+    , vertex_count_(graph.GetVertexCount())
+{
+    std::vector<std::vector<InArc>> in_arcs(vertex_count_);
+    std::vector<size_t> importance(vertex_count_, 1);
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        for (const auto& arc : graph.GetArcs(vertex)) {
+            if (arc.weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+            in_arcs[arc.to].push_back({static_cast<uint32_t>(vertex), arc.edge_id, arc.weight});
+        }
+    }
+
+    // важность вершины - произведение степеней: через вершины с большим числом рёбер проходит больше путей
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        const auto arcs = graph.GetArcs(vertex);
+        importance[vertex] = (static_cast<size_t>(arcs.end() - arcs.begin()) + 1) * (in_arcs[vertex].size() + 1);
+    }
+    hub_vertices_.resize(vertex_count_);
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        hub_vertices_[vertex] = static_cast<uint32_t>(vertex);
+    }
+    std::stable_sort(hub_vertices_.begin(), hub_vertices_.end(), [&importance](uint32_t lhs, uint32_t rhs) {
+        return importance[lhs] > importance[rhs];
+    });
+
+    BuildLabels out_labels(vertex_count_);
+    BuildLabels in_labels(vertex_count_);
+    search_weights_.assign(vertex_count_, INFINITE_WEIGHT);
+    search_edges_.assign(vertex_count_, NO_EDGE);
+    hub_weights_.assign(vertex_count_, INFINITE_WEIGHT);
+    for (uint32_t rank = 0; rank < vertex_count_; ++rank) {
+        PrunedSearch(hub_vertices_[rank], rank, true, in_arcs, out_labels, in_labels);
+        PrunedSearch(hub_vertices_[rank], rank, false, in_arcs, out_labels, in_labels);
+    }
+    search_weights_ = {};
+    search_edges_ = {};
+    hub_weights_ = {};
+
+    FlattenLabels(out_labels, out_offsets_, out_labels_);
+    FlattenLabels(in_labels, in_offsets_, in_labels_);
+    hub_vertices_data_ = hub_vertices_.data();
+    out_offsets_data_ = out_offsets_.data();
+    out_labels_data_ = out_labels_.data();
+    in_offsets_data_ = in_offsets_.data();
+    in_labels_data_ = in_labels_.data();
+}
+
+template <typename Weight>
+HubLabelRouter<Weight>::HubLabelRouter(const Graph& graph, const uint32_t* hub_vertices,
+                                       const uint32_t* out_offsets, const LabelEntry* out_labels,
+                                       const uint32_t* in_offsets, const LabelEntry* in_labels)
+    : graph_(graph)
+    , vertex_count_(graph.GetVertexCount())
+    , hub_vertices_data_(hub_vertices)
+    , out_offsets_data_(out_offsets)
+    , out_labels_data_(out_labels)
+    , in_offsets_data_(in_offsets)
+    , in_labels_data_(in_labels) {
+}
+
+template <typename Weight>
+void HubLabelRouter<Weight>::PrunedSearch(VertexId hub, uint32_t rank, bool forward,
+                                          const std::vector<std::vector<InArc>>& in_arcs,
+                                          BuildLabels& out_labels, BuildLabels& in_labels) {
+    // вес через уже построенные хабы: метка хаба со своей стороны раскладывается по рангам
+    const auto& hub_label = forward ? out_labels[hub] : in_labels[hub];
+    for (const auto& entry : hub_label) {
+        hub_weights_[entry.hub] = entry.weight;
+    }
+    const auto covered_weight = [&](VertexId vertex) {
+        Weight best = INFINITE_WEIGHT;
+        for (const auto& entry : forward ? in_labels[vertex] : out_labels[vertex]) {
+            if (hub_weights_[entry.hub] != INFINITE_WEIGHT) {
+                best = std::min(best, hub_weights_[entry.hub] + entry.weight);
+            }
+        }
+        return best;
+    };
+
+    std::vector<VertexId> touched = {hub};
+    Queue queue;
+    search_weights_[hub] = ZERO_WEIGHT;
+    queue.push({ZERO_WEIGHT, hub});
+
+    while (!queue.empty()) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (weight > search_weights_[vertex]) {
+            continue; // устаревший элемент кучи
+        }
+        // путь уже покрыт хабами большей важности - вершина не получает метку и не раскрывается
+        if (covered_weight(vertex) <= weight) {
+            continue;
+        }
+        auto& label = forward ? in_labels[vertex] : out_labels[vertex];
+        label.push_back({rank, search_edges_[vertex], weight});
+
+        if (forward) {
+            for (const auto& arc : graph_.GetArcs(vertex)) {
+                const Weight candidate_weight = weight + arc.weight;
+                if (candidate_weight < search_weights_[arc.to]) {
+                    if (search_weights_[arc.to] == INFINITE_WEIGHT) {
+                        touched.push_back(arc.to);
+                    }
+                    search_weights_[arc.to] = candidate_weight;
+                    search_edges_[arc.to] = arc.edge_id;
+                    queue.push({candidate_weight, arc.to});
+                }
+            }
+        } else {
+            for (const auto& arc : in_arcs[vertex]) {
+                const Weight candidate_weight = weight + arc.weight;
+                if (candidate_weight < search_weights_[arc.from]) {
+                    if (search_weights_[arc.from] == INFINITE_WEIGHT) {
+                        touched.push_back(arc.from);
+                    }
+                    search_weights_[arc.from] = candidate_weight;
+                    search_edges_[arc.from] = arc.edge_id;
+                    queue.push({candidate_weight, arc.from});
+                }
+            }
+        }
+    }
+
+    for (const VertexId vertex : touched) {
+        search_weights_[vertex] = INFINITE_WEIGHT;
+        search_edges_[vertex] = NO_EDGE;
+    }
+    for (const auto& entry : hub_label) {
+        hub_weights_[entry.hub] = INFINITE_WEIGHT;
+    }
+}
+
+template <typename Weight>
+void HubLabelRouter<Weight>::FlattenLabels(const BuildLabels& labels, std::vector<uint32_t>& offsets,
+                                           std::vector<LabelEntry>& entries) {
+    offsets.assign(1, 0);
+    for (const auto& label : labels) {
+        offsets.push_back(offsets.back() + static_cast<uint32_t>(label.size()));
+    }
+    entries.reserve(offsets.back());
+    for (const auto& label : labels) {
+        entries.insert(entries.end(), label.begin(), label.end());
+    }
+}
+
+template <typename Weight>
+const typename HubLabelRouter<Weight>::LabelEntry&
+HubLabelRouter<Weight>::FindEntry(const LabelEntry* begin, const LabelEntry* end, uint32_t hub) {
+    const auto it = std::lower_bound(begin, end, hub, [](const LabelEntry& entry, uint32_t value) {
+        return entry.hub < value;
+    });
+    if (it == end || it->hub != hub) {
+        throw std::logic_error("Hub label chain is broken");
+    }
+    return *it;
+}
+
+template <typename Weight>
+std::optional<typename HubLabelRouter<Weight>::RouteInfo> HubLabelRouter<Weight>::BuildRoute(VertexId from,
+                                                                                             VertexId to) const {
+    SearchStats stats;
+    return BuildRouteWithStats(from, to, stats);
+}
+
+template <typename Weight>
+std::optional<typename HubLabelRouter<Weight>::RouteInfo>
+HubLabelRouter<Weight>::BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const {
+    if (from >= vertex_count_ || to >= vertex_count_) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    stats = {};
+
+    uint32_t best_hub = 0;
+    const Weight best_weight = MergeLabels(from, to, best_hub, stats);
+    if (best_weight == INFINITE_WEIGHT) {
+        return std::nullopt;
+    }
+
+    // from -> хаб по первым рёбрам исходящих меток, хаб -> to по последним рёбрам входящих меток
+    const VertexId hub_vertex = hub_vertices_data_[best_hub];
+    std::vector<EdgeId> edges;
+    for (VertexId vertex = from; vertex != hub_vertex;) {
+        const auto& entry = FindEntry(out_labels_data_ + out_offsets_data_[vertex],
+                                      out_labels_data_ + out_offsets_data_[vertex + 1], best_hub);
+        edges.push_back(entry.edge_id);
+        vertex = graph_.GetEdge(entry.edge_id).to;
+    }
+    const size_t hub_position = edges.size();
+    for (VertexId vertex = to; vertex != hub_vertex;) {
+        const auto& entry = FindEntry(in_labels_data_ + in_offsets_data_[vertex],
+                                      in_labels_data_ + in_offsets_data_[vertex + 1], best_hub);
+        edges.push_back(entry.edge_id);
+        vertex = graph_.GetEdge(entry.edge_id).from;
+    }
+    std::reverse(edges.begin() + hub_position, edges.end());
+
+    return RouteInfo{best_weight, std::move(edges)};
+}
+
+template <typename Weight>
+std::vector<std::optional<Weight>> HubLabelRouter<Weight>::BuildWeights(const std::vector<VertexId>& from,
+                                                                        const std::vector<VertexId>& to) const {
+    std::vector<std::optional<Weight>> weights;
+    weights.reserve(from.size() * to.size());
+    SearchStats stats;
+    for (const VertexId vertex_from : from) {
+        for (const VertexId vertex_to : to) {
+            if (vertex_from >= vertex_count_ || vertex_to >= vertex_count_) {
+                throw std::out_of_range("Vertex id is out of range");
+            }
+            uint32_t hub = 0;
+            const Weight weight = MergeLabels(vertex_from, vertex_to, hub, stats);
+            weights.push_back(weight == INFINITE_WEIGHT ? std::nullopt : std::optional<Weight>(weight));
+        }
+    }
+    return weights;
+}
+
+template <typename Weight>
+Weight HubLabelRouter<Weight>::MergeLabels(VertexId from, VertexId to, uint32_t& best_hub, SearchStats& stats) const {
+    // метки упорядочены по рангу хаба
+    const LabelEntry* out_it = out_labels_data_ + out_offsets_data_[from];
+    const LabelEntry* out_end = out_labels_data_ + out_offsets_data_[from + 1];
+    const LabelEntry* in_it = in_labels_data_ + in_offsets_data_[to];
+    const LabelEntry* in_end = in_labels_data_ + in_offsets_data_[to + 1];
+    Weight best_weight = INFINITE_WEIGHT;
+    while (out_it != out_end && in_it != in_end) {
+        ++stats.settled_vertices;
+        if (out_it->hub < in_it->hub) {
+            ++out_it;
+        } else if (in_it->hub < out_it->hub) {
+            ++in_it;
+        } else {
+            const Weight weight = out_it->weight + in_it->weight;
+            if (weight < best_weight) {
+                best_weight = weight;
+                best_hub = out_it->hub;
+            }
+            ++out_it;
+            ++in_it;
+        }
+    }
+    return best_weight;
+}
+
+template <typename Weight>
+typename HubLabelRouter<Weight>::LabelStats HubLabelRouter<Weight>::GetLabelStats() const {
+    LabelStats stats;
+    if (vertex_count_ == 0) {
+        return stats;
+    }
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        const size_t out_size = out_offsets_data_[vertex + 1] - out_offsets_data_[vertex];
+        const size_t in_size = in_offsets_data_[vertex + 1] - in_offsets_data_[vertex];
+        stats.max_entries = std::max({stats.max_entries, out_size, in_size});
+    }
+    stats.total_entries = out_offsets_data_[vertex_count_] + in_offsets_data_[vertex_count_];
+    stats.average_entries = static_cast<double>(stats.total_entries) / vertex_count_;
+    stats.memory_bytes = stats.total_entries * sizeof(LabelEntry) + (3 * vertex_count_ + 2) * sizeof(uint32_t);
+    return stats;
+}
+
+}  // namespace graph
@@ -15,6 +15,11 @@ BusBaseRequest JsonReader::ParseBus(const Dict& dict) {
         request.stops.push_back(node.AsString());
     }
     request.is_roundtrip = dict.at("is_roundtrip"s).AsBool();   
+    if (dict.count("departures"s)) {
+        for (const auto& node : dict.at("departures"s).AsArray()) {
+            request.departures.push_back(node.AsDouble());
+        }
+    }
     return request;
 }
 
@@ -36,6 +41,30 @@ StatRequest JsonReader::ParseStat(const Dict& dict) {
     request.name = (dict.count("name"s) ? dict.at("name"s).AsString() : "without name for 'map'-request"s);
     request.to = (dict.count("to"s) ? dict.at("to"s).AsString() : "without 'to'"s);  
     request.from = (dict.count("from"s) ? dict.at("from"s).AsString() : "without 'from'"s); 
+    if (dict.count("time_budget"s)) {
+        request.time_budget = dict.at("time_budget"s).AsDouble();
+    }
+    if (dict.count("render_map"s)) {
+        request.render_map = dict.at("render_map"s).AsBool();
+    }
+    if (dict.count("departure_time"s)) {
+        request.departure_time = dict.at("departure_time"s).AsDouble();
+    }
+    if (dict.count("count"s)) {
+        // count < 1 не даёт ни одного маршрута - на такой запрос отвечаем "not found"
+        const int count = dict.at("count"s).AsInt();
+        request.route_count = count > 0 ? static_cast<size_t>(count) : 0;
+    }
+    if (dict.count("origins"s)) {
+        for (const auto& stop : dict.at("origins"s).AsArray()) {
+            request.origins.push_back(stop.AsString());
+        }
+    }
+    if (dict.count("destinations"s)) {
+        for (const auto& stop : dict.at("destinations"s).AsArray()) {
+            request.destinations.push_back(stop.AsString());
+        }
+    }
     return request;
 }
 
@@ -81,6 +110,9 @@ RenderSettings JsonReader::ParseRenderSettings(const Dict& dict) {
 	for (const auto& color : dict.at("color_palette"s).AsArray()) {
 		settings.color_palette.push_back(ParseColor(color));
 	}
+	if (dict.count("highlight_color"s)) {
+		settings.highlight_color = ParseColor(dict.at("highlight_color"s));
+	}
     return settings;
 }
 
@@ -88,9 +120,62 @@ RouterSettings JsonReader::ParseRouterSettings(const Dict& dict) {
     RouterSettings settings;
     settings.bus_wait_time_ = static_cast<size_t>(dict.at("bus_wait_time"s).AsInt());
     settings.bus_velocity_ = dict.at("bus_velocity"s).AsDouble();
+    if (dict.count("router_type"s)) {
+        settings.router_type_ = ParseRouterType(dict.at("router_type"s).AsString());
+    }
+    if (dict.count("router_threads"s)) {
+        settings.router_threads_ = static_cast<size_t>(dict.at("router_threads"s).AsInt());
+    }
+    if (dict.count("graph_model"s)) {
+        settings.graph_model_ = ParseGraphModel(dict.at("graph_model"s).AsString());
+    }
+    if (dict.count("max_transfers"s)) {
+        settings.max_transfers_ = static_cast<size_t>(dict.at("max_transfers"s).AsInt());
+    }
+    if (dict.count("route_cache_capacity"s)) {
+        settings.route_cache_capacity_ = static_cast<size_t>(dict.at("route_cache_capacity"s).AsInt());
+    }
+    if (dict.count("vertex_order"s)) {
+        settings.vertex_order_ = ParseVertexOrder(dict.at("vertex_order"s).AsString());
+    }
+    return settings;
+}
+
+SerializationSettings JsonReader::ParseSerializationSettings(const Dict& dict) {
+    SerializationSettings settings;
+    settings.file = dict.at("file"s).AsString();
     return settings;
 }
 
+RouterType JsonReader::ParseRouterType(const std::string& type) {
+    static const std::unordered_map<std::string, RouterType> router_types = {
+        {"all_pairs"s, RouterType::ALL_PAIRS},
+        {"dijkstra"s, RouterType::DIJKSTRA},
+        {"ch"s, RouterType::CONTRACTION_HIERARCHY},
+        {"astar"s, RouterType::ASTAR},
+        {"raptor"s, RouterType::RAPTOR},
+        {"hub_labels"s, RouterType::HUB_LABELS},
+        {"all_pairs_compact"s, RouterType::ALL_PAIRS_COMPACT}
+    };
+    return router_types.at(type);
+}
+
+GraphModel JsonReader::ParseGraphModel(const std::string& model) {
+    static const std::unordered_map<std::string, GraphModel> graph_models = {
+        {"stop_pairs"s, GraphModel::STOP_PAIRS},
+        {"route_patterns"s, GraphModel::ROUTE_PATTERNS}
+    };
+    return graph_models.at(model);
+}
+
+VertexOrder JsonReader::ParseVertexOrder(const std::string& order) {
+    static const std::unordered_map<std::string, VertexOrder> vertex_orders = {
+        {"catalogue"s, VertexOrder::CATALOGUE},
+        {"hilbert"s, VertexOrder::HILBERT}
+    };
+    return vertex_orders.at(order);
+}
+
 void JsonReader::LoadFromJson(std::istream& input) {
     auto load_from_json = Load(input).GetRoot().AsDict();
     
@@ -119,15 +204,20 @@ void JsonReader::LoadFromJson(std::istream& input) {
     // добавляем routing_settings в tr.router
     rh_.AddRouterSettings(ParseRouterSettings(std::move(load_from_json.at("routing_settings"s).AsDict())));
     
-    // добавляем количество вершин в tr.router и строим маршрутизатор 
-    rh_.SetTransportRouter(); 
+    // добавляем serialization_settings (необязательные): маршрутизатор загружается из файла или сохраняется в него
+    if (load_from_json.count("serialization_settings"s)) {
+        rh_.AddSerializationSettings(ParseSerializationSettings(load_from_json.at("serialization_settings"s).AsDict()));
+    }
 
-    // добавляем все запросы на вывод информации из справочника
+    /*
+    добавляем все запросы на вывод информации из справочника (маршруты считаются пакетно по остановке отправления);
+    маршрутизатор строится только при запросах к нему, в фоне, пока отвечаются остальные запросы
+    */
+    std::vector<StatRequest> stat_requests;
     for (const auto &item : std::move(load_from_json.at("stat_requests"s).AsArray())) {
-        auto request = item.AsDict();
-        auto type = request.at("type"s).AsString();
-        rh_.AddStatResult(ParseStat(std::move(request)));
+        stat_requests.push_back(ParseStat(item.AsDict()));
     }
+    rh_.AddStatResults(stat_requests);
 
 }
 
@@ -170,6 +260,29 @@ void JsonReader::PrintIntoJson(std::ostream& output) {
             } else {
                 request_dict = AddErrorInfoIntoDict(id);
             }
+
+        // выводим матрицу времени маршрутов
+        } else if (std::holds_alternative<StatResultMatrix>(stat_res)) {
+            const auto& [id, times] = std::get<StatResultMatrix>(stat_res);
+            request_dict = AddTravelTimesIntoDict(id, times);
+
+        // выводим несколько маршрутов: оптимальные по времени и числу пересадок или альтернативные
+        } else if (std::holds_alternative<StatResultRoutes>(stat_res)) {
+            const auto& [id, routes] = std::get<StatResultRoutes>(stat_res);
+            if (routes != std::nullopt && !routes->empty()) {
+                request_dict = AddRoutesIntoDict(id, routes.value());
+            } else {
+                request_dict = AddErrorInfoIntoDict(id);
+            }
+
+        // выводим остановки, достижимые за отведённое время
+        } else if (std::holds_alternative<StatResultIsochrone>(stat_res)) {
+            const auto& [id, isochrone] = std::get<StatResultIsochrone>(stat_res);
+            if (isochrone != std::nullopt) {
+                request_dict = AddIsochroneIntoDict(id, isochrone.value());
+            } else {
+                request_dict = AddErrorInfoIntoDict(id);
+            }
         }
         
         json_output.emplace_back(std::move(request_dict)); 
@@ -230,7 +343,7 @@ Dict JsonReader::AddSVGIntoDict(const int id, const std::string& svg_map) {
     }.AsDict();
 }
 
-Dict JsonReader::AddRouteInfoIntoDict(const int id, const RouteInfo& route_info) {
+Array JsonReader::MakeRouteItems(const RouteInfo& route_info) {
     Array spans;
     for (const auto& route_edge : route_info.route_edges) {
 
@@ -240,7 +353,7 @@ Dict JsonReader::AddRouteInfoIntoDict(const int id, const RouteInfo& route_info)
             Node dict = Builder{}
                 .StartDict()
                     .Key("type").Value("Wait")
-                    .Key("stop_name").Value(wait_edge_info.name)
+                    .Key("stop_name").Value(std::string(rh_.GetStopName(wait_edge_info.stop)))
                     .Key("time").Value(wait_edge_info.time)
                 .EndDict()
                 .Build();
@@ -252,7 +365,7 @@ Dict JsonReader::AddRouteInfoIntoDict(const int id, const RouteInfo& route_info)
             Node dict = Builder{}
                 .StartDict()
                     .Key("type").Value("Bus")
-                    .Key("bus").Value(bus_edge_info.name)
+                    .Key("bus").Value(std::string(rh_.GetBusName(bus_edge_info.bus)))
                     .Key("span_count").Value(static_cast<int>(bus_edge_info.span_count))
                     .Key("time").Value(bus_edge_info.time)
                     .EndDict()
@@ -261,15 +374,92 @@ Dict JsonReader::AddRouteInfoIntoDict(const int id, const RouteInfo& route_info)
         }
     }
 
+    return spans;
+}
+
+Dict JsonReader::AddRouteInfoIntoDict(const int id, const RouteInfo& route_info) {
     return Node{
         Builder{}
         .StartDict()
             .Key("request_id").Value(id)
             .Key("total_time").Value(route_info.time)
-            .Key("items").Value(spans)
+            .Key("items").Value(MakeRouteItems(route_info))
         .EndDict()
         .Build()
     }.AsDict();
 }
 
+Dict JsonReader::AddRoutesIntoDict(const int id, const std::vector<RouteInfo>& routes) {
+    // маршруты по возрастанию времени, wait_count - число ожиданий (поездок)
+    Array route_dicts;
+    for (const auto& route_info : routes) {
+        const auto wait_count = std::count_if(route_info.route_edges.begin(), route_info.route_edges.end(),
+            [](const EdgeInfo& edge_info) {
+                return std::holds_alternative<WaitEdgeInfo>(edge_info);
+            });
+        route_dicts.push_back(Builder{}
+            .StartDict()
+                .Key("total_time"s).Value(route_info.time)
+                .Key("wait_count"s).Value(static_cast<int>(wait_count))
+                .Key("items"s).Value(MakeRouteItems(route_info))
+            .EndDict()
+            .Build());
+    }
+
+    return Node{
+        Builder{}
+        .StartDict()
+            .Key("request_id"s).Value(id)
+            .Key("routes"s).Value(std::move(route_dicts))
+        .EndDict()
+        .Build()
+    }.AsDict();
+}
+
+Dict JsonReader::AddTravelTimesIntoDict(const int id, const TravelTimes& times) {
+    // строка - остановка отправления, столбец - остановка прибытия, null - маршрута нет
+    Array rows;
+    for (const auto& row_times : times) {
+        Array row;
+        for (const auto& time : row_times) {
+            row.push_back(time ? Node(*time) : Node(nullptr));
+        }
+        rows.push_back(std::move(row));
+    }
+
+    return Node{
+        Builder{}
+        .StartDict()
+            .Key("request_id"s).Value(id)
+            .Key("total_times"s).Value(std::move(rows))
+        .EndDict()
+        .Build()
+    }.AsDict();
+}
+
+Dict JsonReader::AddIsochroneIntoDict(const int id, const IsochroneInfo& isochrone) {
+    Array stops;
+    for (const auto& [name, time] : isochrone.stops) {
+        stops.push_back(Builder{}
+            .StartDict()
+                .Key("stop_name"s).Value(name)
+                .Key("time"s).Value(time)
+            .EndDict()
+            .Build());
+    }
+
+    Dict dict = Node{
+        Builder{}
+        .StartDict()
+            .Key("request_id"s).Value(id)
+            .Key("stops"s).Value(std::move(stops))
+        .EndDict()
+        .Build()
+    }.AsDict();
+    if (!isochrone.map.empty()) {
+        dict["map"s] = isochrone.map;
+    }
+    return dict;
+}
+
 } // namespace json_reader
\ No newline at end of file
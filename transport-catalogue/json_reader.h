@@ -8,10 +8,12 @@
 #include "domain.h"
 #include "transport_router.h"
 
+#include <algorithm>
 #include <iostream>
 #include <optional> 
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <variant> 
 #include <vector>
 
@@ -52,14 +54,33 @@ public:
     // возвращает структуру с параметрами для графа
     domain::RouterSettings ParseRouterSettings(const json::Dict& dict);
 
+    // возвращает структуру с настройками сохранения маршрутизатора
+    domain::SerializationSettings ParseSerializationSettings(const json::Dict& dict);
+
+    // возвращает тип маршрутизатора по названию: all_pairs, dijkstra, ch, astar, raptor, hub_labels,
+    // all_pairs_compact
+    domain::RouterType ParseRouterType(const std::string& type);
+
+    // возвращает модель графа по названию: stop_pairs, route_patterns
+    domain::GraphModel ParseGraphModel(const std::string& model);
+
+    // возвращает нумерацию вершин остановок по названию: catalogue, hilbert
+    domain::VertexOrder ParseVertexOrder(const std::string& order);
+
     // заполняют request_dict по ссылке результатами по запросу на вывод информации
     json::Dict AddBusStatIntoDict(const int id, const domain::BusInfo& info);
     json::Dict AddStopStatIntoDict(const int id, const domain::StopInfo& info);
     json::Dict AddErrorInfoIntoDict(const int id);
     json::Dict AddSVGIntoDict(const int id, const std::string& svg_map);
     json::Dict AddRouteInfoIntoDict(const int id, const domain::RouteInfo& route_info);
+    json::Dict AddRoutesIntoDict(const int id, const std::vector<domain::RouteInfo>& routes);
+    json::Dict AddTravelTimesIntoDict(const int id, const domain::TravelTimes& times);
+    json::Dict AddIsochroneIntoDict(const int id, const domain::IsochroneInfo& isochrone);
 
 private:
+    // звенья маршрута (Wait и Bus) для ответов Route, ParetoRoute и RouteAlternatives
+    json::Array MakeRouteItems(const domain::RouteInfo& route_info);
+
     request_handler::RequestHandler& rh_; //методы для обработки запросов
 
 };
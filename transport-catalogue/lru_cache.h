@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+
+/*
+ограниченный кэш с вытеснением давно не использованных элементов (LRU), безопасный для нескольких потоков:
+список хранит элементы от недавно использованного к давнему, словарь - позиции элементов в списке
+*/
+namespace lru_cache {
+
+// счётчики кэша: попадания, промахи, вытеснения и текущее число элементов
+struct CacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t size = 0;
+};
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    // capacity = 0 - кэш выключен: ничего не хранит и не считает
+    explicit LruCache(size_t capacity = 0)
+        : capacity_(capacity) {
+    }
+
+    // копия значения по ключу; найденный элемент становится самым недавним
+    std::optional<Value> Get(const Key& key) {
+        std::lock_guard guard(mutex_);
+        if (capacity_ == 0) {
+            return std::nullopt;
+        }
+        const auto it = positions_.find(key);
+        if (it == positions_.end()) {
+            ++stats_.misses;
+            return std::nullopt;
+        }
+        ++stats_.hits;
+        items_.splice(items_.begin(), items_, it->second);
+        return it->second->second;
+    }
+
+    // добавляет или заменяет значение; при переполнении вытесняется самый давний элемент
+    void Put(const Key& key, Value value) {
+        std::lock_guard guard(mutex_);
+        if (capacity_ == 0) {
+            return;
+        }
+        if (const auto it = positions_.find(key); it != positions_.end()) {
+            it->second->second = std::move(value);
+            items_.splice(items_.begin(), items_, it->second);
+            return;
+        }
+        if (items_.size() == capacity_) {
+            positions_.erase(items_.back().first);
+            items_.pop_back();
+            ++stats_.evictions;
+        }
+        items_.emplace_front(key, std::move(value));
+        positions_[key] = items_.begin();
+    }
+
+    // удаляет все элементы, счётчики сохраняются
+    void Clear() {
+        std::lock_guard guard(mutex_);
+        items_.clear();
+        positions_.clear();
+    }
+
+    // задаёт ёмкость, лишние давние элементы вытесняются
+    void SetCapacity(size_t capacity) {
+        std::lock_guard guard(mutex_);
+        capacity_ = capacity;
+        while (items_.size() > capacity_) {
+            positions_.erase(items_.back().first);
+            items_.pop_back();
+            ++stats_.evictions;
+        }
+    }
+
+    CacheStats GetStats() const {
+        std::lock_guard guard(mutex_);
+        CacheStats stats = stats_;
+        stats.size = items_.size();
+        return stats;
+    }
+
+private:
+    using Items = std::list<std::pair<Key, Value>>;
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    Items items_;
+    std::unordered_map<Key, typename Items::iterator, Hash> positions_;
+    CacheStats stats_;
+};
+
+} // namespace lru_cache
@@ -159,10 +159,14 @@ namespace map_renderer {
 		return routes_names;
 	}
 
-	std::vector<Circle> MapRendererSVG::AllStopsToSymbs(const std::vector<Stop>& stops) {
+	std::vector<Circle> MapRendererSVG::AllStopsToSymbs(const std::vector<Stop>& stops,
+	                                                    const std::unordered_set<std::string_view>& highlighted_stops) {
 		std::vector<Circle> symbols;
 		for (const auto& stop : stops) {
 			symbols.emplace_back(StopToSymb(stop.coordinates));
+			if (highlighted_stops.count(stop.name)) {
+				symbols.back().SetFillColor(settings_.highlight_color);
+			}
 		}
 		return symbols;
 	}
@@ -176,7 +180,8 @@ namespace map_renderer {
 	}
 
 
-	void MapRendererSVG::RenderMap(std::ostream& out, const std::vector<Bus>& buses, const std::vector<Stop>& stops) {
+	void MapRendererSVG::RenderMap(std::ostream& out, const std::vector<Bus>& buses, const std::vector<Stop>& stops,
+	                               const std::unordered_set<std::string_view>& highlighted_stops) {
 		SetSphereProjector(stops); // один раз настроить проекцию здесь
 		svg::Document doc;
 		// Слой 1. Добавляем все линии маршрутов в svg-документ
@@ -189,7 +194,7 @@ namespace map_renderer {
 			doc.Add(route_name.text);
     	}
 		// Слой 3. Добавляем символы кругов для остановок в svg-документ
-		for (const auto& stop : AllStopsToSymbs(stops)) {
+		for (const auto& stop : AllStopsToSymbs(stops, highlighted_stops)) {
 			doc.Add(stop); 
 		}
 		// Слой 4. Добавляем названия остановок в svg-документ
@@ -10,6 +10,8 @@
 #include <optional>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <unordered_set>
 
 
 /*
@@ -142,6 +144,9 @@ struct RenderSettings {
 
     // цветовая палитра. Непустой массив.
     std::vector<svg::Color> color_palette;
+
+    // цвет заливки выделенных остановок (достижимых в запросе Isochrone). Необязательный, по умолчанию красный
+    svg::Color highlight_color = std::string("red");
 };    
     
 class MapRendererSVG {
@@ -176,14 +181,16 @@ public:
     // возвращает svg-текст с названиями маршрутов для всех маршрутов
     std::vector<map_renderer::NameSVG> AllRoutesToText(const std::vector<domain::Bus>& buses);
 
-    // возвращает svg-круги для всех остановок 
-    std::vector<svg::Circle> AllStopsToSymbs(const std::vector<domain::Stop>& stops);
+    // возвращает svg-круги для всех остановок, остановки из highlighted_stops заливаются цветом выделения
+    std::vector<svg::Circle> AllStopsToSymbs(const std::vector<domain::Stop>& stops,
+                                             const std::unordered_set<std::string_view>& highlighted_stops = {});
 
     // возвращает svg-название и подложку для заданной остановки
     std::vector<map_renderer::NameSVG> AllStopsToText(const std::vector<domain::Stop>& stops);
 
-    // рендерит карту маршрутов
-    void RenderMap(std::ostream& out, const std::vector<domain::Bus>& buses, const std::vector<domain::Stop>& stop);
+    // рендерит карту маршрутов, выделяя остановки highlighted_stops
+    void RenderMap(std::ostream& out, const std::vector<domain::Bus>& buses, const std::vector<domain::Stop>& stop,
+                   const std::unordered_set<std::string_view>& highlighted_stops = {});
 
     
 
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+
+// поиск маршрутов, оптимальных по Парето по двум критериям: весу и числу отмеченных рёбер
+namespace graph {
+
+// маршрут фронта Парето: вес, число отмеченных рёбер и рёбра маршрута
+template <typename Weight>
+struct ParetoRoute {
+    Weight weight;
+    size_t count;
+    std::vector<EdgeId> edges;
+};
+
+// max_count в SearchParetoRoutes без ограничения счётчика
+inline constexpr size_t UNLIMITED_COUNT = std::numeric_limits<size_t>::max();
+
+/*
+фронт Парето маршрутов from -> to по весу и числу рёбер, для которых is_counted(edge_id) истинно, за один поиск
+с метками (алгоритм Мартинса). У вершины - мешок взаимно недоминируемых меток (вес, счётчик); новая метка,
+доминируемая меткой мешка, отбрасывается, а доминируемые ею метки удаляются. Метки извлекаются из кучи
+в лексикографическом порядке (вес, счётчик), поэтому извлечённая метка from -> to окончательна, а метки
+со счётчиком не меньше, чем у уже найденного маршрута, сразу отсекаются. max_count ограничивает счётчик
+(и размер мешков), UNLIMITED_COUNT - без ограничения. Маршруты идут по возрастанию веса и убыванию счётчика
+*/
+template <typename Weight, typename IsCounted>
+std::vector<ParetoRoute<Weight>> SearchParetoRoutes(const CompactGraph<Weight>& graph, VertexId from, VertexId to,
+                                                    IsCounted is_counted, size_t max_count,
+                                                    SearchStats& stats) {
+    const size_t vertex_count = graph.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    stats = {};
+
+    static constexpr uint32_t NO_LABEL = std::numeric_limits<uint32_t>::max();
+
+    // метка: вес и счётчик пути, вершина, метка-предок и последнее ребро пути
+    struct Label {
+        Weight weight;
+        uint32_t count;
+        uint32_t vertex;
+        uint32_t parent;
+        EdgeId edge_id;
+        bool dominated;
+    };
+    std::vector<Label> labels;
+    std::vector<std::vector<uint32_t>> bags(vertex_count); // номера неотброшенных меток вершины
+
+    using QueueItem = std::tuple<Weight, uint32_t, uint32_t>; // вес, счётчик, номер метки
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+    labels.push_back({Weight{}, 0, static_cast<uint32_t>(from), NO_LABEL, 0, false});
+    bags[from].push_back(0);
+    queue.push({Weight{}, 0, 0});
+
+    std::vector<uint32_t> target_labels;
+    uint32_t best_count = NO_LABEL; // наименьший счётчик найденных маршрутов
+    while (!queue.empty()) {
+        const auto [weight, count, label] = queue.top();
+        queue.pop();
+        if (labels[label].dominated) {
+            continue;
+        }
+        ++stats.settled_vertices;
+        const VertexId vertex = labels[label].vertex;
+        if (vertex == to) {
+            target_labels.push_back(label);
+            best_count = count;
+            if (count == 0) {
+                break; // маршрута с меньшим счётчиком нет
+            }
+            continue;
+        }
+
+        for (const auto& arc : graph.GetArcs(vertex)) {
+            ++stats.relaxed_edges;
+            const Weight candidate_weight = weight + arc.weight;
+            const uint32_t candidate_count = count + (is_counted(arc.edge_id) ? 1 : 0);
+            if (candidate_count > max_count || candidate_count >= best_count) {
+                continue; // найденный маршрут не тяжелее и с не большим счётчиком
+            }
+
+            auto& bag = bags[arc.to];
+            bool is_dominated = false;
+            for (const uint32_t other : bag) {
+                if (!(candidate_weight < labels[other].weight) && labels[other].count <= candidate_count) {
+                    is_dominated = true;
+                    break;
+                }
+            }
+            if (is_dominated) {
+                continue;
+            }
+            for (size_t i = 0; i < bag.size();) {
+                auto& other = labels[bag[i]];
+                if (!(other.weight < candidate_weight) && candidate_count <= other.count) {
+                    other.dominated = true;
+                    bag[i] = bag.back();
+                    bag.pop_back();
+                } else {
+                    ++i;
+                }
+            }
+
+            const auto candidate = static_cast<uint32_t>(labels.size());
+            labels.push_back({candidate_weight, candidate_count, static_cast<uint32_t>(arc.to), label,
+                              arc.edge_id, false});
+            bag.push_back(candidate);
+            queue.push({candidate_weight, candidate_count, candidate});
+        }
+    }
+
+    // маршруты по цепочкам предков
+    std::vector<ParetoRoute<Weight>> routes;
+    routes.reserve(target_labels.size());
+    for (const uint32_t target_label : target_labels) {
+        ParetoRoute<Weight> route{labels[target_label].weight, labels[target_label].count, {}};
+        for (uint32_t label = target_label; labels[label].parent != NO_LABEL; label = labels[label].parent) {
+            route.edges.push_back(labels[label].edge_id);
+        }
+        std::reverse(route.edges.begin(), route.edges.end());
+        routes.push_back(std::move(route));
+    }
+    return routes;
+}
+
+}  // namespace graph
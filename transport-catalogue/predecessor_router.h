@@ -0,0 +1,213 @@
+#pragma once
+
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// предрасчёт всех пар с таблицей только последних рёбер маршрутов
+namespace graph {
+
+/*
+маршрутизатор с предрасчётом всех пар, хранящий для пары from -> to только последнее ребро маршрута
+узкого типа PrevEdge (uint16_t или uint32_t - по числу рёбер графа, см. MakePredecessorRouter).
+Веса в таблице не хранятся: вес маршрута складывается по рёбрам при восстановлении пути,
+поэтому таблица в 4-8 раз меньше таблицы Router, а ответ по-прежнему без поиска.
+Строки таблицы - деревья кратчайших путей поиска Дейкстры из каждой вершины, строки считаются параллельно
+*/
+template <typename Weight, typename PrevEdge>
+class PredecessorRouter : public RouterBase<Weight> {
+private:
+    using Graph = CompactGraph<Weight>;
+
+    static_assert(std::is_unsigned_v<PrevEdge>, "PrevEdge should be an unsigned integer type");
+
+public:
+    using typename RouterBase<Weight>::RouteInfo;
+
+    // последнее значение типа означает отсутствие ребра, поэтому рёбер в графе должно быть меньше
+    static constexpr size_t MAX_EDGE_COUNT = std::numeric_limits<PrevEdge>::max();
+
+    explicit PredecessorRouter(const Graph& graph, size_t thread_count = 1);
+
+    // маршрутизатор по готовой таблице V x V (например, отображённой в память из файла), таблица не копируется
+    PredecessorRouter(const Graph& graph, const PrevEdge* prev_edges);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    // веса складываются по рёбрам маршрутов, описания маршрутов не собираются
+    std::vector<std::optional<Weight>> BuildWeights(const std::vector<VertexId>& from,
+                                                    const std::vector<VertexId>& to) const override;
+
+    // весов в таблице нет, деревья кратчайших путей при масштабировании рёбер те же
+    bool ScaleWeights(double /*factor*/) override {
+        return std::is_floating_point_v<Weight>;
+    }
+
+    // таблица для сохранения: GetTableSize() последних рёбер маршрутов
+    const PrevEdge* GetPrevEdges() const {
+        return prev_edges_data_;
+    }
+    size_t GetTableSize() const {
+        return vertex_count_ * vertex_count_;
+    }
+
+private:
+    static constexpr PrevEdge NO_EDGE = std::numeric_limits<PrevEdge>::max();
+    static constexpr Weight ZERO_WEIGHT{};
+
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    size_t GetIndex(VertexId from, VertexId to) const {
+        return from * vertex_count_ + to;
+    }
+
+    // поиск Дейкстры из from, последние рёбра маршрутов записываются в строку from таблицы
+    void FillRow(VertexId from, std::vector<std::optional<Weight>>& weights) {
+        PrevEdge* row = prev_edges_.data() + GetIndex(from, 0);
+        std::fill(weights.begin(), weights.end(), std::nullopt);
+        Queue queue;
+        weights[from] = ZERO_WEIGHT;
+        queue.push({ZERO_WEIGHT, from});
+        while (!queue.empty()) {
+            const auto [weight, vertex] = queue.top();
+            queue.pop();
+            if (*weights[vertex] < weight) {
+                continue; // устаревший элемент кучи
+            }
+            for (const auto& arc : graph_.GetArcs(vertex)) {
+                const Weight candidate_weight = weight + arc.weight;
+                if (!weights[arc.to] || candidate_weight < *weights[arc.to]) {
+                    weights[arc.to] = candidate_weight;
+                    row[arc.to] = static_cast<PrevEdge>(arc.edge_id);
+                    queue.push({candidate_weight, arc.to});
+                }
+            }
+        }
+    }
+
+    // маршрут from -> to по цепочке последних рёбер (рёбра от начала маршрута) и его вес; nullopt, если маршрута нет
+    std::optional<Weight> CollectRoute(VertexId from, VertexId to, std::vector<EdgeId>& edges) const {
+        if (from >= vertex_count_ || to >= vertex_count_) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        edges.clear();
+        if (from != to && prev_edges_data_[GetIndex(from, to)] == NO_EDGE) {
+            return std::nullopt;
+        }
+        for (PrevEdge edge_id = prev_edges_data_[GetIndex(from, to)];
+             edge_id != NO_EDGE;
+             edge_id = prev_edges_data_[GetIndex(from, graph_.GetEdge(edge_id).from)])
+        {
+            edges.push_back(edge_id);
+        }
+        std::reverse(edges.begin(), edges.end());
+
+        // вес складывается от начала маршрута, как при поиске, которым строилась таблица
+        Weight weight = ZERO_WEIGHT;
+        for (const EdgeId edge_id : edges) {
+            weight = weight + graph_.GetEdge(edge_id).weight;
+        }
+        return weight;
+    }
+
+    const Graph& graph_;
+    size_t vertex_count_;
+    std::vector<PrevEdge> prev_edges_; // последние рёбра маршрутов from -> to, индекс from * vertex_count_ + to
+    const PrevEdge* prev_edges_data_ = nullptr; // собственная или внешняя таблица
+};
+
+template <typename Weight, typename PrevEdge>
+PredecessorRouter<Weight, PrevEdge>::PredecessorRouter(const Graph& graph, size_t thread_count)
+    : graph_(graph)
+    , vertex_count_(graph.GetVertexCount())
+    , prev_edges_(vertex_count_ * vertex_count_, NO_EDGE)
+{
+    if (graph.GetEdgeCount() > MAX_EDGE_COUNT) {
+        throw std::length_error("Too many edges for the predecessor table");
+    }
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        for (const auto& arc : graph.GetArcs(vertex)) {
+            if (arc.weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+        }
+    }
+
+    // строки независимы: поток берёт каждую worker_count-ю, рабочий массив весов у потока свой
+    const size_t worker_count = std::max<size_t>(1, std::min(thread_count, vertex_count_));
+    const auto fill_rows = [this, worker_count](size_t worker) {
+        std::vector<std::optional<Weight>> weights(vertex_count_);
+        for (VertexId from = worker; from < vertex_count_; from += worker_count) {
+            FillRow(from, weights);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t worker = 1; worker < worker_count; ++worker) {
+        workers.emplace_back(fill_rows, worker);
+    }
+    fill_rows(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    prev_edges_data_ = prev_edges_.data();
+}
+
+template <typename Weight, typename PrevEdge>
+PredecessorRouter<Weight, PrevEdge>::PredecessorRouter(const Graph& graph, const PrevEdge* prev_edges)
+    : graph_(graph)
+    , vertex_count_(graph.GetVertexCount())
+    , prev_edges_data_(prev_edges) {
+}
+
+template <typename Weight, typename PrevEdge>
+std::optional<typename PredecessorRouter<Weight, PrevEdge>::RouteInfo>
+PredecessorRouter<Weight, PrevEdge>::BuildRoute(VertexId from, VertexId to) const {
+    std::vector<EdgeId> edges;
+    const auto weight = CollectRoute(from, to, edges);
+    if (!weight) {
+        return std::nullopt;
+    }
+    return RouteInfo{*weight, std::move(edges)};
+}
+
+template <typename Weight, typename PrevEdge>
+std::vector<std::optional<Weight>> PredecessorRouter<Weight, PrevEdge>::BuildWeights(const std::vector<VertexId>& from,
+                                                                                     const std::vector<VertexId>& to) const {
+    std::vector<std::optional<Weight>> weights;
+    weights.reserve(from.size() * to.size());
+    std::vector<EdgeId> edges; // общий буфер рёбер для всех пар
+    for (const VertexId vertex_from : from) {
+        for (const VertexId vertex_to : to) {
+            weights.push_back(CollectRoute(vertex_from, vertex_to, edges));
+        }
+    }
+    return weights;
+}
+
+/*
+маршрутизатор с таблицей последних рёбер самого узкого подходящего типа:
+uint16_t, если рёбер не больше 65535, иначе uint32_t
+*/
+template <typename Weight>
+std::unique_ptr<RouterBase<Weight>> MakePredecessorRouter(const CompactGraph<Weight>& graph, size_t thread_count = 1) {
+    if (graph.GetEdgeCount() <= PredecessorRouter<Weight, uint16_t>::MAX_EDGE_COUNT) {
+        return std::make_unique<PredecessorRouter<Weight, uint16_t>>(graph, thread_count);
+    }
+    return std::make_unique<PredecessorRouter<Weight, uint32_t>>(graph, thread_count);
+}
+
+}  // namespace graph
@@ -0,0 +1,296 @@
+#include "raptor_router.h"
+
+#include <algorithm>
+#include <utility>
+
+
+namespace transport_router {
+    using namespace domain;
+
+    // меньше маршрутов на поток не выгоднее последовательного просмотра
+    static constexpr size_t MIN_PATTERNS_PER_THREAD = 64;
+
+    RaptorRouter::RaptorRouter(const transport_catalogue::TransportCatalogue& db, double bus_wait_time,
+                               SegmentTime segment_time, size_t max_trips, size_t thread_count)
+        : db_(db)
+        , bus_wait_time_(bus_wait_time)
+        , max_rounds_(max_trips)
+        , thread_count_(std::max<size_t>(thread_count, 1))
+        , workers_(thread_count_)
+    {
+        const auto& stops = db_.GetStops();
+        for (size_t i = 0; i < stops.size(); ++i) {
+            stop_indexes_[&stops[i]] = static_cast<uint32_t>(i);
+        }
+
+        // маршруты направлений: прямой маршрут A,B,C даёт A,B,C и C,B,A
+        std::unordered_map<const Bus*, std::vector<uint32_t>> bus_to_patterns;
+        const auto add_pattern = [&](const Bus& bus, const std::vector<const Stop*>& route) {
+            Pattern pattern{ bus.id, {}, {} };
+            for (size_t i = 0; i < route.size(); ++i) {
+                pattern.stops.push_back(stop_indexes_.at(route[i]));
+                if (i + 1 < route.size()) {
+                    pattern.segment_times.push_back(segment_time(route[i], route[i + 1]));
+                }
+            }
+            bus_to_patterns[&bus].push_back(static_cast<uint32_t>(patterns_.size()));
+            patterns_.push_back(std::move(pattern));
+        };
+        for (const auto& bus : db_.GetBuses()) {
+            if (bus.route.empty()) {
+                continue;
+            }
+            add_pattern(bus, bus.route);
+            if (!bus.is_roundtrip) {
+                add_pattern(bus, std::vector<const Stop*>(bus.route.rbegin(), bus.route.rend()));
+            }
+        }
+
+        // маршруты через остановку - по автобусам остановки из справочника
+        stop_patterns_.resize(stops.size());
+        for (size_t stop = 0; stop < stops.size(); ++stop) {
+            const auto* buses = db_.GetBusesByStop(stops[stop].name);
+            if (buses == nullptr) {
+                continue;
+            }
+            for (const Bus* bus : *buses) {
+                for (const uint32_t pattern : bus_to_patterns[bus]) {
+                    const auto& pattern_stops = patterns_[pattern].stops;
+                    const auto it = std::find(pattern_stops.begin(), pattern_stops.end(), stop);
+                    stop_patterns_[stop].push_back({ pattern, static_cast<uint32_t>(it - pattern_stops.begin()) });
+                }
+            }
+            // порядок автобусов в множестве не определён, а от порядка зависит выбор среди равных маршрутов
+            std::sort(stop_patterns_[stop].begin(), stop_patterns_[stop].end(),
+                [](const StopPattern& lhs, const StopPattern& rhs) {
+                    return lhs.pattern < rhs.pattern;
+                });
+        }
+    }
+
+    std::optional<RouteInfo> RaptorRouter::FindRoute(const Stop* from, const Stop* to, graph::SearchStats& stats) const {
+        stats = {};
+        const uint32_t from_index = GetStopIndex(from);
+        const uint32_t to_index = GetStopIndex(to);
+        if (from_index == NONE || to_index == NONE) {
+            return std::nullopt;
+        }
+        return MakeRouteInfo(Run(from_index, to_index, stats), to_index);
+    }
+
+    std::vector<std::optional<RouteInfo>> RaptorRouter::FindRoutes(const Stop* from,
+                                                                   const std::vector<const Stop*>& to) const {
+        std::vector<std::optional<RouteInfo>> routes(to.size());
+        const uint32_t from_index = GetStopIndex(from);
+        if (from_index == NONE) {
+            return routes;
+        }
+        graph::SearchStats stats;
+        const Rounds rounds = Run(from_index, NONE, stats);
+        for (size_t i = 0; i < to.size(); ++i) {
+            const uint32_t to_index = GetStopIndex(to[i]);
+            if (to_index != NONE) {
+                routes[i] = MakeRouteInfo(rounds, to_index);
+            }
+        }
+        return routes;
+    }
+
+    TravelTimes RaptorRouter::FindTravelTimes(const std::vector<const Stop*>& from,
+                                              const std::vector<const Stop*>& to) const {
+        TravelTimes times(from.size(), std::vector<std::optional<double>>(to.size()));
+        for (size_t i = 0; i < from.size(); ++i) {
+            const uint32_t from_index = GetStopIndex(from[i]);
+            if (from_index == NONE) {
+                continue;
+            }
+            graph::SearchStats stats;
+            const Rounds rounds = Run(from_index, NONE, stats);
+            for (size_t j = 0; j < to.size(); ++j) {
+                const uint32_t to_index = GetStopIndex(to[j]);
+                if (to_index != NONE && rounds.back()[to_index].time != INFINITE_TIME) {
+                    times[i][j] = rounds.back()[to_index].time;
+                }
+            }
+        }
+        return times;
+    }
+
+    std::vector<RouteInfo> RaptorRouter::FindParetoRoutes(const Stop* from, const Stop* to) const {
+        std::vector<RouteInfo> routes;
+        const uint32_t from_index = GetStopIndex(from);
+        const uint32_t to_index = GetStopIndex(to);
+        if (from_index == NONE || to_index == NONE) {
+            return routes;
+        }
+        graph::SearchStats stats;
+        const Rounds rounds = Run(from_index, to_index, stats);
+        for (size_t round = 0; round < rounds.size(); ++round) {
+            const double time = rounds[round][to_index].time;
+            if (time != INFINITE_TIME && (round == 0 || time < rounds[round - 1][to_index].time)) {
+                routes.push_back(*MakeRouteInfo(rounds, to_index, round));
+            }
+        }
+        std::reverse(routes.begin(), routes.end());
+        return routes;
+    }
+
+    std::vector<ReachableStop> RaptorRouter::FindReachableStops(const Stop* from, double time_budget) const {
+        std::vector<ReachableStop> reachable_stops;
+        const uint32_t from_index = GetStopIndex(from);
+        if (from_index == NONE) {
+            return reachable_stops;
+        }
+        graph::SearchStats stats;
+        const Rounds rounds = Run(from_index, NONE, stats);
+        const auto& stops = db_.GetStops();
+        for (uint32_t stop = 0; stop < stops.size(); ++stop) {
+            if (rounds.back()[stop].time <= time_budget) {
+                reachable_stops.push_back({ stops[stop].name, rounds.back()[stop].time });
+            }
+        }
+        std::stable_sort(reachable_stops.begin(), reachable_stops.end(),
+            [](const ReachableStop& lhs, const ReachableStop& rhs) {
+                return lhs.time < rhs.time;
+            });
+        return reachable_stops;
+    }
+
+    RaptorRouter::Rounds RaptorRouter::Run(uint32_t from, uint32_t target, graph::SearchStats& stats) const {
+        const size_t stop_count = stop_patterns_.size();
+        Rounds rounds(1, std::vector<Label>(stop_count));
+        rounds[0][from].time = 0.0;
+        std::vector<double> best_times(stop_count, INFINITE_TIME);
+        best_times[from] = 0.0;
+
+        std::vector<uint32_t> marked_stops = { from };
+        std::vector<bool> is_marked(stop_count, false);
+        std::vector<uint32_t> pattern_starts(patterns_.size(), NONE);
+
+        for (size_t round = 1; (max_rounds_ == 0 || round <= max_rounds_) && !marked_stops.empty(); ++round) {
+            // маршруты через улучшенные остановки просматриваются с первой из них
+            std::vector<uint32_t> queued_patterns;
+            for (const uint32_t stop : marked_stops) {
+                for (const auto& [pattern, position] : stop_patterns_[stop]) {
+                    if (pattern_starts[pattern] == NONE) {
+                        queued_patterns.push_back(pattern);
+                        pattern_starts[pattern] = position;
+                    } else {
+                        pattern_starts[pattern] = std::min(pattern_starts[pattern], position);
+                    }
+                }
+                is_marked[stop] = false;
+            }
+            marked_stops.clear();
+            std::sort(queued_patterns.begin(), queued_patterns.end());
+
+            // метки раунда начинаются с меток прошлого раунда
+            rounds.push_back(rounds.back());
+            const auto& previous = rounds[round - 1];
+            auto& current = rounds[round];
+            const double time_bound = target != NONE ? best_times[target] : INFINITE_TIME;
+
+            // маршруты делятся между потоками, улучшения собираются в буферы потоков и применяются по порядку маршрутов
+            const size_t chunk_count = std::max<size_t>(1,
+                std::min(thread_count_, queued_patterns.size() / MIN_PATTERNS_PER_THREAD));
+            std::vector<std::vector<Candidate>> candidates(chunk_count);
+            std::vector<size_t> scanned_stops(chunk_count, 0);
+            const auto scan_chunk = [&](size_t chunk) {
+                const size_t begin = queued_patterns.size() * chunk / chunk_count;
+                const size_t end = queued_patterns.size() * (chunk + 1) / chunk_count;
+                for (size_t i = begin; i < end; ++i) {
+                    ScanPattern(queued_patterns[i], pattern_starts[queued_patterns[i]], previous, best_times,
+                                time_bound, candidates[chunk], scanned_stops[chunk]);
+                }
+            };
+            workers_.Run(chunk_count, scan_chunk);
+            for (const uint32_t pattern : queued_patterns) {
+                pattern_starts[pattern] = NONE;
+            }
+
+            for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+                stats.relaxed_edges += scanned_stops[chunk];
+                for (const auto& [stop, label] : candidates[chunk]) {
+                    const double bound = target != NONE ? best_times[target] : INFINITE_TIME;
+                    if (label.time < best_times[stop] && label.time < bound) {
+                        current[stop] = label;
+                        best_times[stop] = label.time;
+                        ++stats.settled_vertices;
+                        if (!is_marked[stop]) {
+                            is_marked[stop] = true;
+                            marked_stops.push_back(stop);
+                        }
+                    }
+                }
+            }
+        }
+        return rounds;
+    }
+
+    void RaptorRouter::ScanPattern(uint32_t pattern, uint32_t start, const std::vector<Label>& previous,
+                                   const std::vector<double>& best_times, double time_bound,
+                                   std::vector<Candidate>& candidates, size_t& scanned_stops) const {
+        const auto& [bus, stops, segment_times] = patterns_[pattern];
+        double trip_time = INFINITE_TIME; // время прибытия на текущую остановку в поездке по маршруту
+        uint32_t board_position = NONE;
+        for (uint32_t position = start; position < stops.size(); ++position) {
+            const uint32_t stop = stops[position];
+            ++scanned_stops;
+
+            // высадка: поездка улучшает метку остановки
+            if (board_position != NONE && trip_time < best_times[stop] && trip_time < time_bound) {
+                candidates.push_back({ stop, { trip_time, pattern, board_position, position } });
+            }
+
+            // посадка после ожидания, если на остановку с меньшим числом поездок приехали раньше
+            const double board_time = previous[stop].time + bus_wait_time_;
+            if (board_time < trip_time) {
+                trip_time = board_time;
+                board_position = position;
+            }
+            if (board_position != NONE && position + 1 < stops.size()) {
+                trip_time += segment_times[position];
+            }
+        }
+    }
+
+    std::optional<RouteInfo> RaptorRouter::MakeRouteInfo(const Rounds& rounds, uint32_t to, size_t round) const {
+        if (round == NONE) {
+            round = rounds.size() - 1;
+        }
+        if (rounds[round][to].time == INFINITE_TIME) {
+            return std::nullopt;
+        }
+
+        // идём от конца по поездкам, каждая поездка взята из метки не более позднего раунда
+        std::vector<EdgeInfo> route_edges;
+        for (uint32_t stop = to; rounds[round][stop].pattern != NONE; --round) {
+            const auto& label = rounds[round][stop];
+            const auto& pattern = patterns_[label.pattern];
+            double time = 0.0;
+            for (uint32_t position = label.board_position; position < label.alight_position; ++position) {
+                time += pattern.segment_times[position];
+            }
+            route_edges.emplace_back(BusEdgeInfo{ pattern.bus, time, label.alight_position - label.board_position });
+            stop = pattern.stops[label.board_position];
+            route_edges.emplace_back(WaitEdgeInfo{ stop, bus_wait_time_ });
+        }
+        std::reverse(route_edges.begin(), route_edges.end());
+
+        double total_time = 0.0;
+        for (const auto& edge_info : route_edges) {
+            if (std::holds_alternative<WaitEdgeInfo>(edge_info)) {
+                total_time += std::get<WaitEdgeInfo>(edge_info).time;
+            } else {
+                total_time += std::get<BusEdgeInfo>(edge_info).time;
+            }
+        }
+        return RouteInfo{ total_time, std::move(route_edges) };
+    }
+
+    uint32_t RaptorRouter::GetStopIndex(const Stop* stop) const {
+        const auto it = stop_indexes_.find(stop);
+        return it == stop_indexes_.end() ? NONE : it->second;
+    }
+
+} // namespace transport_router
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "domain.h"
+#include "router.h"
+#include "transport_catalogue.h"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/*
+поиск маршрутов по раундам (RAPTOR) прямо по маршрутам справочника, без графа:
+раунд k находит лучшее время прибытия на остановки не более чем за k поездок,
+в раунде просматриваются только маршруты через остановки, улучшенные в прошлом раунде
+*/
+namespace transport_router {
+
+class RaptorRouter {
+public:
+    // время на перегоне между соседними остановками маршрута
+    using SegmentTime = std::function<double(const domain::Stop*, const domain::Stop*)>;
+
+    /*
+    max_trips - наибольшее число поездок в маршруте (пересадок на одну меньше), 0 - без ограничения;
+    thread_count - число потоков просмотра маршрутов внутри раунда
+    */
+    RaptorRouter(const transport_catalogue::TransportCatalogue& db, double bus_wait_time, SegmentTime segment_time,
+                 size_t max_trips = 0, size_t thread_count = 1);
+
+    // оптимальный маршрут между остановками; счётчики: улучшенные метки остановок и просмотренные остановки маршрутов
+    std::optional<domain::RouteInfo> FindRoute(const domain::Stop* from, const domain::Stop* to,
+                                               graph::SearchStats& stats) const;
+
+    // оптимальные маршруты от одной остановки до нескольких за один поиск
+    std::vector<std::optional<domain::RouteInfo>> FindRoutes(const domain::Stop* from,
+                                                             const std::vector<const domain::Stop*>& to) const;
+
+    // время маршрутов всех пар from x to: один поиск из каждой остановки from, маршруты не собираются
+    domain::TravelTimes FindTravelTimes(const std::vector<const domain::Stop*>& from,
+                                        const std::vector<const domain::Stop*>& to) const;
+
+    /*
+    фронт Парето по времени и числу поездок из раундов одного поиска: маршрут раунда k войдёт во фронт,
+    если он быстрее маршрута раунда k - 1. Маршруты по возрастанию времени (и убыванию числа поездок)
+    */
+    std::vector<domain::RouteInfo> FindParetoRoutes(const domain::Stop* from, const domain::Stop* to) const;
+
+    // остановки, достижимые из from не более чем за time_budget, по возрастанию времени
+    std::vector<domain::ReachableStop> FindReachableStops(const domain::Stop* from, double time_budget) const;
+
+private:
+    static constexpr double INFINITE_TIME = std::numeric_limits<double>::infinity();
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    // маршрут одного направления автобуса: остановки и время на перегонах (segment_times[i] - от i до i + 1)
+    struct Pattern {
+        domain::BusId bus;
+        std::vector<uint32_t> stops;
+        std::vector<double> segment_times;
+    };
+
+    // маршрут через остановку и первая позиция остановки на нём
+    struct StopPattern {
+        uint32_t pattern;
+        uint32_t position;
+    };
+
+    // метка остановки в раунде: время и поездка, которой достигнута остановка
+    struct Label {
+        double time = INFINITE_TIME;
+        uint32_t pattern = NONE;
+        uint32_t board_position = NONE;
+        uint32_t alight_position = NONE;
+    };
+
+    // улучшение метки, найденное при просмотре маршрута
+    struct Candidate {
+        uint32_t stop;
+        Label label;
+    };
+
+    // метки всех раундов поиска из одной остановки
+    using Rounds = std::vector<std::vector<Label>>;
+
+    // выполняет раунды из from; при target != NONE отсекает метки не лучше найденного времени до target
+    Rounds Run(uint32_t from, uint32_t target, graph::SearchStats& stats) const;
+
+    // просматривает маршрут с позиции start по меткам прошлого раунда
+    void ScanPattern(uint32_t pattern, uint32_t start, const std::vector<Label>& previous,
+                     const std::vector<double>& best_times, double time_bound,
+                     std::vector<Candidate>& candidates, size_t& scanned_stops) const;
+
+    // собирает маршрут до остановки to по меткам раундов, начиная с раунда round (по умолчанию последнего)
+    std::optional<domain::RouteInfo> MakeRouteInfo(const Rounds& rounds, uint32_t to, size_t round = NONE) const;
+
+    // номер остановки или NONE, если её нет в справочнике
+    uint32_t GetStopIndex(const domain::Stop* stop) const;
+
+    const transport_catalogue::TransportCatalogue& db_;
+    double bus_wait_time_;
+    size_t max_rounds_;
+    size_t thread_count_;
+    mutable graph::WorkerPool workers_; // потоки просмотра маршрутов, общие для всех раундов и поисков
+    std::vector<Pattern> patterns_;
+    std::vector<std::vector<StopPattern>> stop_patterns_; // номер остановки - маршруты через неё
+    std::unordered_map<const domain::Stop*, uint32_t> stop_indexes_; // остановка - номер в справочнике
+};
+
+} // namespace transport_router
@@ -18,6 +18,14 @@ const std::unordered_set<const Bus*>* RequestHandler::GetBusesByStop(const std::
     return db_.GetBusesByStop(stop_name);
 }
 
+std::string_view RequestHandler::GetStopName(StopId id) const {
+    return db_.GetStopName(id);
+}
+
+std::string_view RequestHandler::GetBusName(BusId id) const {
+    return db_.GetBusName(id);
+}
+
 void RequestHandler::AddBusBaseRequest(const BusBaseRequest& request) {
     bus_base_requests_.emplace_back(request);
 }
@@ -26,16 +34,97 @@ void RequestHandler::AddStopBaseRequest(const StopBaseRequest& request) {
     stop_base_requests_.emplace_back(request);
 }
 
-void RequestHandler::AddStatResult(const StatRequest& request) { //переработать через variant, чтобы не было обращения к полю type
+void RequestHandler::AddStatResult(const StatRequest& request) {
+    if (UsesTransportRouter(request)) {
+        WaitTransportRouter();
+    }
+    stat_results_.emplace_back(MakeStatResult(request));
+}
+
+StatResult RequestHandler::MakeStatResult(const StatRequest& request) { //переработать через variant, чтобы не было обращения к полю type
     if (request.type == "Bus"s) {
-        stat_results_.emplace_back(std::make_pair(request.id, db_.GetBusInfo(request.name)));
+        return std::make_pair(request.id, db_.GetBusInfo(request.name));
     } else if (request.type == "Stop"s) {
-        stat_results_.emplace_back(std::make_pair(request.id, db_.GetStopInfo(request.name)));
+        return std::make_pair(request.id, db_.GetStopInfo(request.name));
     } else if (request.type == "Map"s) {
-        stat_results_.emplace_back(std::make_pair(request.id, GetStringSVG()));
+        return std::make_pair(request.id, GetStringSVG());
+    } else if (request.type == "Route"s && request.departure_time) {
+        return std::make_pair(request.id, ro_.GetTimetableRoute(request.from, request.to, *request.departure_time));
     } else if (request.type == "Route"s) {
-        stat_results_.emplace_back(std::make_pair(request.id, ro_.GetOptimalRoute(request.from, request.to)));
+        return std::make_pair(request.id, ro_.GetOptimalRoute(request.from, request.to));
+    } else if (request.type == "Matrix"s) {
+        return std::make_pair(request.id, ro_.GetTravelTimes(request.origins, request.destinations));
+    } else if (request.type == "Isochrone"s) {
+        return std::make_pair(request.id, GetIsochrone(request));
+    } else if (request.type == "ParetoRoute"s) {
+        return std::make_pair(request.id, ro_.GetParetoRoutes(request.from, request.to));
+    } else if (request.type == "RouteAlternatives"s) {
+        return std::make_pair(request.id, ro_.GetAlternativeRoutes(request.from, request.to, request.route_count));
+    }
+    return nullptr;
+}
+
+bool RequestHandler::UsesTransportRouter(const StatRequest& request) {
+    return request.type == "Route"s || request.type == "Matrix"s || request.type == "Isochrone"s
+        || request.type == "ParetoRoute"s || request.type == "RouteAlternatives"s;
+}
+
+void RequestHandler::AddStatResults(const std::vector<StatRequest>& requests) {
+    // маршрутизатор строится в фоне, пока отвечаются запросы, которым он не нужен
+    const bool uses_router = std::any_of(requests.begin(), requests.end(), UsesTransportRouter);
+    if (uses_router) {
+        StartTransportRouter();
+    }
+    std::vector<StatResult> results(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (!UsesTransportRouter(requests[i])) {
+            results[i] = MakeStatResult(requests[i]);
+        }
+    }
+    if (!uses_router) {
+        std::move(results.begin(), results.end(), std::back_inserter(stat_results_));
+        return;
+    }
+    WaitTransportRouter();
+
+    // группируем запросы Route без времени отправления по остановке отправления (в порядке первого появления)
+    const auto is_grouped = [&requests](size_t i) {
+        return requests[i].type == "Route"s && !requests[i].departure_time;
+    };
+    std::unordered_map<std::string_view, size_t> from_to_group;
+    std::vector<std::vector<size_t>> groups;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (!is_grouped(i)) {
+            continue;
+        }
+        const auto [it, inserted] = from_to_group.emplace(requests[i].from, groups.size());
+        if (inserted) {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(i);
+    }
+
+    std::vector<std::optional<RouteInfo>> routes(requests.size());
+    for (const auto& group : groups) {
+        std::vector<std::string> to_stops;
+        to_stops.reserve(group.size());
+        for (const size_t index : group) {
+            to_stops.push_back(requests[index].to);
+        }
+        auto group_routes = ro_.GetOptimalRoutes(requests[group.front()].from, to_stops);
+        for (size_t i = 0; i < group.size(); ++i) {
+            routes[group[i]] = std::move(group_routes[i]);
+        }
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (is_grouped(i)) {
+            results[i] = std::make_pair(requests[i].id, std::move(routes[i]));
+        } else if (UsesTransportRouter(requests[i])) {
+            results[i] = MakeStatResult(requests[i]);
+        }
     }
+    std::move(results.begin(), results.end(), std::back_inserter(stat_results_));
 }
 
 void RequestHandler::ApplyAllRequests() const { 
@@ -51,7 +140,9 @@ void RequestHandler::ApplyAllRequests() const {
         for (const auto& stop: request.stops) {
             route.push_back(db_.FindStop(stop));
         } 
-        db_.AddBus({ request.is_roundtrip, request.name, std::move(route) });
+        Bus bus{ request.is_roundtrip, request.name, std::move(route) };
+        bus.departures = request.departures;
+        db_.AddBus(bus);
     }
 
     // устанавливаем расстояния между остановками
@@ -71,9 +162,41 @@ void RequestHandler::AddRouterSettings(const RouterSettings& settings) {
     ro_.SetRouterSettings(settings);
 }
 
+void RequestHandler::AddSerializationSettings(const SerializationSettings& settings) {
+    serialization_settings_ = settings;
+}
+
 void RequestHandler::SetTransportRouter() {
+    is_router_built_ = true;
     ro_.SetVertexCount(db_.GetStops().size());
-    ro_.BuildTransportRouter();
+    if (serialization_settings_.file.empty()) {
+        ro_.BuildTransportRouter();
+        return;
+    }
+
+    // файл построен для другого справочника или настроек - маршрутизатор строится заново и пересохраняется
+    if (!ro_.LoadFromFile(serialization_settings_.file)) {
+        ro_.BuildTransportRouter();
+        ro_.SaveToFile(serialization_settings_.file);
+    }
+}
+
+void RequestHandler::StartTransportRouter() {
+    if (router_build_.valid() || is_router_built_) {
+        return;
+    }
+    // справочник уже заполнен и дальше только читается, поэтому его можно читать параллельно с построением
+    router_build_ = std::async(std::launch::async, [this] {
+        SetTransportRouter();
+    });
+}
+
+void RequestHandler::WaitTransportRouter() {
+    if (router_build_.valid()) {
+        router_build_.get(); // исключение построения передаётся сюда
+    } else if (!is_router_built_) {
+        SetTransportRouter();
+    }
 }
 
 const std::vector<domain::StatResult>& RequestHandler::GetStatResults() const {
@@ -117,5 +240,23 @@ const std::string RequestHandler::GetStringSVG() const {
     mr_.RenderMap(strm, buses_, stops_);
     return strm.str();
 }
+
+std::optional<IsochroneInfo> RequestHandler::GetIsochrone(const StatRequest& request) const {
+    auto reachable_stops = ro_.GetReachableStops(request.from, request.time_budget);
+    if (!reachable_stops) {
+        return std::nullopt;
+    }
+    IsochroneInfo isochrone{ std::move(*reachable_stops), {} };
+    if (request.render_map) {
+        std::unordered_set<std::string_view> highlighted_stops;
+        for (const auto& stop : isochrone.stops) {
+            highlighted_stops.insert(stop.name);
+        }
+        std::ostringstream strm;
+        mr_.RenderMap(strm, buses_, stops_, highlighted_stops);
+        isochrone.map = strm.str();
+    }
+    return isochrone;
+}
       
 } //namespace request_handler
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include "transport_router.h"
 
 #include <algorithm>
+#include <future>
+#include <iterator>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -42,15 +44,27 @@ public:
     // Возвращает маршруты (запрос Stop)
     const std::unordered_set<const domain::Bus*>* GetBusesByStop(const std::string_view& stop_name) const;
 
+    // Названия остановки и автобуса по номерам из описаний рёбер маршрута
+    std::string_view GetStopName(domain::StopId id) const;
+    std::string_view GetBusName(domain::BusId id) const;
+
     // Добавление запроса на добавление автобуса
     void AddBusBaseRequest(const domain::BusBaseRequest& request);
 
     // Добавление запроса на добавление остановки
     void AddStopBaseRequest(const domain::StopBaseRequest& request);
 
-    // Добавление запроса на вывод c получением результата BusInfo/StopInfo
+    // Добавление запроса на вывод c получением результата BusInfo/StopInfo (маршрутизатор строится при первой нужде)
     void AddStatResult(const domain::StatRequest& request);
 
+    /*
+    Добавление пакета запросов на вывод: запросы Route с общей остановкой отправления (без времени отправления)
+    вычисляются одним поиском, результаты сохраняются в исходном порядке запросов.
+    Маршрутизатор строится, только если в пакете есть запросы к нему (Route, Matrix, Isochrone, ParetoRoute,
+    RouteAlternatives), причём в фоне, пока отвечаются остальные запросы
+    */
+    void AddStatResults(const std::vector<domain::StatRequest>& requests);
+
     // Выполнение запросов на добавление информации в транспортный справочник
     void ApplyAllRequests() const;
 
@@ -60,9 +74,15 @@ public:
     // Добавление настроек графа
     void AddRouterSettings(const domain::RouterSettings& settings);
 
-    // Добавление количества вершин графа и построение маршрутизатора
+    // Добавление настроек сохранения маршрутизатора в файл
+    void AddSerializationSettings(const domain::SerializationSettings& settings);
+
+    // Добавление количества вершин графа и построение маршрутизатора (или загрузка из файла, если он задан)
     void SetTransportRouter();
 
+    // Начинает построение маршрутизатора в отдельном потоке, если он ещё не построен и не строится
+    void StartTransportRouter();
+
     // Получение результатов по запросам на вывод информации из транспортного справочника
     const std::vector<domain::StatResult>& GetStatResults() const;
 
@@ -81,7 +101,19 @@ public:
     // Преобразует SVG-объект из потока в строку
     const std::string GetStringSVG() const;
 
+    // Остановки, достижимые за отведённое время (запрос Isochrone), и карта с ними, если она запрошена
+    std::optional<domain::IsochroneInfo> GetIsochrone(const domain::StatRequest& request) const;
+
 private:
+    // Нужен ли запросу маршрутизатор
+    static bool UsesTransportRouter(const domain::StatRequest& request);
+
+    // Дожидается фонового построения маршрутизатора или строит его, если построение не начато
+    void WaitTransportRouter();
+
+    // Результат запроса на вывод
+    domain::StatResult MakeStatResult(const domain::StatRequest& request);
+
     // RequestHandler использует агрегацию объектов "Транспортный Справочник" и "Визуализатор Карты"
     transport_catalogue::TransportCatalogue& db_;
     map_renderer::MapRendererSVG& mr_;
@@ -95,6 +127,11 @@ private:
 
     std::vector<domain::StatResult> stat_results_; // результаты по запросам на вывод инфомации
 
+    domain::SerializationSettings serialization_settings_; // файл сохранённого маршрутизатора
+
+    bool is_router_built_ = false; // маршрутизатор построен или загружен
+    std::future<void> router_build_; // фоновое построение маршрутизатора
+
 };
 
 } //namespace request_handler
\ No newline at end of file
@@ -4,116 +4,888 @@
 
 #include <algorithm>
 #include <cassert>
+#include <condition_variable>
 #include <cstdint>
+#include <functional>
 #include <iterator>
+#include <limits>
+#include <mutex>
 #include <optional>
+#include <queue>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 
 // поиск кратчайшего пути во взвешенном ориентированном графе
 namespace graph {
 
-template <typename Weight>
-class Router {
-private:
-    using Graph = DirectedWeightedGraph<Weight>;
+// счётчики одного поиска: просмотренные (окончательно) вершины и релаксированные рёбра
+struct SearchStats {
+    size_t settled_vertices = 0;
+    size_t relaxed_edges = 0;
+};
 
+// общий интерфейс маршрутизаторов: предрасчёт всех пар или поиск по запросу
+template <typename Weight>
+class RouterBase {
 public:
-    explicit Router(const Graph& graph);
-
     struct RouteInfo {
         Weight weight;
         std::vector<EdgeId> edges;
     };
 
-    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+    virtual ~RouterBase() = default;
+
+    virtual std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const = 0;
+
+    // то же с подсчётом работы поиска; для маршрутизаторов с предрасчётом счётчики остаются нулевыми
+    virtual std::optional<RouteInfo> BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const {
+        stats = {};
+        return BuildRoute(from, to);
+    }
+
+    // маршруты из одной вершины в несколько; маршрутизаторы по запросу обходятся одним поиском
+    virtual std::vector<std::optional<RouteInfo>> BuildRoutes(VertexId from, const std::vector<VertexId>& to) const {
+        std::vector<std::optional<RouteInfo>> routes;
+        routes.reserve(to.size());
+        for (const VertexId vertex : to) {
+            routes.push_back(BuildRoute(from, vertex));
+        }
+        return routes;
+    }
+
+    // веса маршрутов всех пар from x to без восстановления рёбер, построчно: [i * to.size() + j] - от from[i] до to[j]
+    virtual std::vector<std::optional<Weight>> BuildWeights(const std::vector<VertexId>& from,
+                                                            const std::vector<VertexId>& to) const {
+        std::vector<std::optional<Weight>> weights;
+        weights.reserve(from.size() * to.size());
+        for (const VertexId vertex : from) {
+            for (auto& route : BuildRoutes(vertex, to)) {
+                weights.push_back(route ? std::optional<Weight>(route->weight) : std::nullopt);
+            }
+        }
+        return weights;
+    }
+
+    /*
+    масштабирует предрасчитанные веса после умножения весов всех рёбер графа на factor > 0: кратчайшие маршруты
+    при этом не меняются. false - масштабировать нечего или нельзя, нужен новый предрасчёт
+    */
+    virtual bool ScaleWeights(double /*factor*/) {
+        return false;
+    }
+
+    /*
+    обновляет предрасчёт после изменения графа (CompactGraph::RemoveEdges, затем CompactGraph::AddEdges):
+    edge_ids - новые id прежних рёбер (REMOVED_EDGE для удалённых), рёбра от first_added_edge и вершины
+    после прежних добавлены. false - обновить нельзя, нужен новый предрасчёт
+    */
+    virtual bool UpdateGraph(const std::vector<EdgeId>& /*edge_ids*/, EdgeId /*first_added_edge*/) {
+        return false;
+    }
+};
+
+// барьер для фиксированного числа потоков: Wait возвращается, когда его вызвали все потоки; барьер многоразовый
+class Barrier {
+public:
+    explicit Barrier(size_t thread_count)
+        : thread_count_(thread_count) {
+    }
+
+    void Wait() {
+        std::unique_lock lock(mutex_);
+        const size_t generation = generation_;
+        if (++waiting_count_ == thread_count_) {
+            waiting_count_ = 0;
+            ++generation_;
+            condition_.notify_all();
+            return;
+        }
+        condition_.wait(lock, [this, generation] {
+            return generation_ != generation;
+        });
+    }
+
+private:
+    const size_t thread_count_;
+    size_t waiting_count_ = 0;
+    size_t generation_ = 0; // число пройденных фаз
+    std::mutex mutex_;
+    std::condition_variable condition_;
+};
+
+/*
+постоянные потоки для повторяющихся параллельных шагов: создаются один раз в конструкторе,
+Run(worker_count, task) выполняет task(0) .. task(worker_count - 1) (task(0) - в вызывающем потоке)
+и возвращается после завершения всех. Если пул занят шагом из другого потока, задачи выполняются по очереди
+в вызывающем потоке
+*/
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t thread_count) {
+        for (size_t worker = 1; worker < thread_count; ++worker) {
+            threads_.emplace_back([this, worker] {
+                Work(worker);
+            });
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() {
+        {
+            std::lock_guard lock(mutex_);
+            is_stopping_ = true;
+        }
+        start_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    // число потоков вместе с вызывающим
+    size_t GetThreadCount() const {
+        return threads_.size() + 1;
+    }
+
+    template <typename Task>
+    void Run(size_t worker_count, const Task& task) {
+        worker_count = std::min(worker_count, GetThreadCount());
+        std::unique_lock run_lock(run_mutex_, std::try_to_lock);
+        if (worker_count <= 1 || !run_lock.owns_lock()) {
+            for (size_t worker = 0; worker < worker_count; ++worker) {
+                task(worker);
+            }
+            return;
+        }
+
+        const std::function<void(size_t)> step_task = std::cref(task);
+        {
+            std::lock_guard lock(mutex_);
+            task_ = &step_task;
+            worker_count_ = worker_count;
+            pending_count_ = worker_count - 1;
+            ++generation_;
+        }
+        start_.notify_all();
+        task(0);
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [this] {
+            return pending_count_ == 0;
+        });
+        task_ = nullptr;
+    }
+
+private:
+    void Work(size_t worker) {
+        size_t generation = 0;
+        std::unique_lock lock(mutex_);
+        while (true) {
+            start_.wait(lock, [this, generation] {
+                return is_stopping_ || generation_ != generation;
+            });
+            if (is_stopping_) {
+                return;
+            }
+            generation = generation_;
+            if (worker >= worker_count_) {
+                continue; // в этом шаге задач меньше, чем потоков
+            }
+            const auto* task = task_;
+            lock.unlock();
+            (*task)(worker);
+            lock.lock();
+            if (--pending_count_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::mutex run_mutex_; // один шаг за раз
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    const std::function<void(size_t)>* task_ = nullptr;
+    size_t worker_count_ = 0;
+    size_t pending_count_ = 0; // потоки пула, ещё выполняющие шаг
+    size_t generation_ = 0; // число начатых шагов
+    bool is_stopping_ = false;
+};
 
+/*
+маршрутизатор с предрасчётом всех пар вершин (Флойд-Уоршелл): O(V^3) времени и O(V^2) памяти.
+Таблица хранится двумя плоскими матрицами V x V: веса маршрутов и последнее ребро маршрута,
+недостижимость обозначается значениями INFINITE_WEIGHT и NO_EDGE. Релаксация строки через вершину -
+векторизуемое ядро min-plus (AVX2 или SSE2 для double, AVX2 для uint32_t, скалярный вариант для остальных типов).
+При thread_count > 1 таблица строится блочным алгоритмом: на каждом шаге по блоку промежуточных вершин
+сначала пересчитывается диагональный блок, затем параллельно блоки его строки и столбца, затем все остальные
+*/
+template <typename Weight>
+class Router : public RouterBase<Weight> {
 private:
-    struct RouteInternalData {
+    using Graph = CompactGraph<Weight>;
+
+public:
+    using typename RouterBase<Weight>::RouteInfo;
+
+    explicit Router(const Graph& graph, size_t thread_count = 1);
+
+    // маршрутизатор по готовой таблице V x V (например, отображённой в память из файла), таблица не копируется
+    Router(const Graph& graph, const Weight* weights, const EdgeId* prev_edges);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    // веса читаются из таблицы
+    std::vector<std::optional<Weight>> BuildWeights(const std::vector<VertexId>& from,
+                                                    const std::vector<VertexId>& to) const override;
+
+    // веса таблицы умножаются на factor (последние рёбра маршрутов те же); внешнюю таблицу и целые веса не масштабирует
+    bool ScaleWeights(double factor) override {
+        if (!std::is_floating_point_v<Weight> || weights_data_ != weights_.data()) {
+            return false;
+        }
+        for (Weight& weight : weights_) {
+            weight = static_cast<Weight>(weight * factor); // бесконечность остаётся бесконечностью
+        }
+        return true;
+    }
+
+    /*
+    таблица обновляется без нового предрасчёта. После удаления рёбер в каждой строке заново ищутся только
+    маршруты, проходившие через удалённые рёбра: поиском Дейкстры по этим вершинам от остальных; у прочих
+    маршрутов меняются только id рёбер. Новый маршрут с добавленными рёбрами после последнего из них идёт
+    по прежним рёбрам, поэтому строка релаксируется через строки концов добавленных рёбер: O(V^2 * k)
+    для k различных концов вместо O(V^3). Внешнюю таблицу не обновляет
+    */
+    bool UpdateGraph(const std::vector<EdgeId>& edge_ids, EdgeId first_added_edge) override;
+
+    // таблица маршрутов для сохранения: GetVertexCount() строк весов и последних рёбер маршрутов,
+    // строка from начинается с from * GetRowSize() (после UpdateGraph строки длиннее числа вершин)
+    const Weight* GetWeights() const {
+        return weights_data_;
+    }
+    const EdgeId* GetPrevEdges() const {
+        return prev_edges_data_;
+    }
+    size_t GetVertexCount() const {
+        return vertex_count_;
+    }
+    size_t GetRowSize() const {
+        return row_size_;
+    }
+
+private:
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr Weight INFINITE_WEIGHT = std::numeric_limits<Weight>::has_infinity
+                                            ? std::numeric_limits<Weight>::infinity()
+                                            : std::numeric_limits<Weight>::max();
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+
+    // размер квадратного блока таблицы (вершин по стороне) в блочном алгоритме
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    // входящая дуга: начало ребра, id ребра и вес
+    struct InArc {
+        VertexId from;
+        EdgeId edge_id;
         Weight weight;
-        std::optional<EdgeId> prev_edge;
     };
-    using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+
+    // изменение графа для обновления таблицы
+    struct GraphChange {
+        const std::vector<EdgeId>& edge_ids; // новые id прежних рёбер
+        EdgeId first_added_edge;
+        std::vector<VertexId> edge_froms; // начало каждого ребра нового графа
+        std::vector<size_t> in_offsets; // входящие дуги вершины без добавленных рёбер: [in_offsets[v], in_offsets[v + 1])
+        std::vector<InArc> in_arcs;
+    };
+
+    // добавленное ребро: начало и дуга
+    struct AddedEdge {
+        VertexId from;
+        typename Graph::Arc arc;
+    };
+
+    size_t GetIndex(VertexId from, VertexId to) const {
+        return from * row_size_ + to;
+    }
 
     void InitializeRoutesInternalData(const Graph& graph) {
-        const size_t vertex_count = graph.GetVertexCount();
-        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-            routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
-            for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
-                const auto& edge = graph.GetEdge(edge_id);
-                if (edge.weight < ZERO_WEIGHT) {
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            weights_[GetIndex(vertex, vertex)] = ZERO_WEIGHT;
+            for (const auto& arc : graph.GetArcs(vertex)) {
+                if (arc.weight < ZERO_WEIGHT) {
                     throw std::domain_error("Edges' weights should be non-negative");
                 }
-                auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                if (!route_internal_data || route_internal_data->weight > edge.weight) {
-                    route_internal_data = RouteInternalData{edge.weight, edge_id};
+                const size_t index = GetIndex(vertex, arc.to);
+                if (weights_[index] > arc.weight) {
+                    weights_[index] = arc.weight;
+                    prev_edges_[index] = arc.edge_id;
                 }
             }
         }
     }
 
-    void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-                    const RouteInternalData& route_to) {
-        auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-        const Weight candidate_weight = route_from.weight + route_to.weight;
-        if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-            route_relaxing = {candidate_weight,
-                              route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge};
+    /*
+    ядро min-plus: weights_from[j] = min(weights_from[j], weight_through + weights_through[j]),
+    при улучшении последним ребром маршрута становится последнее ребро маршрута от промежуточной вершины.
+    Строки from и through могут совпадать: тогда улучшений нет, так как вес маршрута through -> through нулевой
+    */
+    static void RelaxRow(Weight* weights_from, EdgeId* prev_edges_from, const Weight* weights_through,
+                         const EdgeId* prev_edges_through, Weight weight_through, size_t count) {
+        size_t j = 0;
+        if constexpr (std::is_same_v<Weight, double> && sizeof(EdgeId) == sizeof(double)) {
+#if defined(__AVX2__)
+            const __m256d through = _mm256_set1_pd(weight_through);
+            for (; j + 4 <= count; j += 4) {
+                const __m256d current = _mm256_loadu_pd(weights_from + j);
+                const __m256d candidate = _mm256_add_pd(through, _mm256_loadu_pd(weights_through + j));
+                const __m256d mask = _mm256_cmp_pd(candidate, current, _CMP_LT_OQ);
+                _mm256_storeu_pd(weights_from + j, _mm256_blendv_pd(current, candidate, mask));
+                const __m256d prev = _mm256_castsi256_pd(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev_edges_from + j)));
+                const __m256d prev_through = _mm256_castsi256_pd(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev_edges_through + j)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(prev_edges_from + j),
+                                    _mm256_castpd_si256(_mm256_blendv_pd(prev, prev_through, mask)));
+            }
+#elif defined(__SSE2__)
+            const __m128d through = _mm_set1_pd(weight_through);
+            for (; j + 2 <= count; j += 2) {
+                const __m128d current = _mm_loadu_pd(weights_from + j);
+                const __m128d candidate = _mm_add_pd(through, _mm_loadu_pd(weights_through + j));
+                const __m128d mask = _mm_cmplt_pd(candidate, current);
+                _mm_storeu_pd(weights_from + j, _mm_or_pd(_mm_and_pd(mask, candidate), _mm_andnot_pd(mask, current)));
+                const __m128i mask_bits = _mm_castpd_si128(mask);
+                const __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev_edges_from + j));
+                const __m128i prev_through = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev_edges_through + j));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(prev_edges_from + j),
+                                 _mm_or_si128(_mm_and_si128(mask_bits, prev_through), _mm_andnot_si128(mask_bits, prev)));
+            }
+#endif
+        } else if constexpr (std::is_same_v<Weight, uint32_t> && sizeof(EdgeId) == sizeof(uint64_t)) {
+#if defined(__AVX2__)
+            // 8 весов за шаг; маска 32-битных полос расширяется до 64-битных для двух четвёрок номеров рёбер
+            const __m256i through = _mm256_set1_epi32(static_cast<int>(weight_through));
+            const __m256i infinite = _mm256_set1_epi32(static_cast<int>(INFINITE_WEIGHT));
+            for (; j + 8 <= count; j += 8) {
+                const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights_from + j));
+                const __m256i row = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights_through + j));
+                const __m256i candidate = _mm256_add_epi32(through, row);
+
+                // остаётся прежнее: нет маршрута через вершину или candidate >= current (сравнение без знака)
+                const __m256i keep = _mm256_or_si256(_mm256_cmpeq_epi32(row, infinite),
+                    _mm256_cmpeq_epi32(_mm256_min_epu32(candidate, current), current));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(weights_from + j),
+                                    _mm256_blendv_epi8(candidate, current, keep));
+                for (size_t half = 0; half < 2; ++half) {
+                    const __m256i keep_edges = _mm256_cvtepi32_epi64(half == 0 ? _mm256_castsi256_si128(keep)
+                                                                              : _mm256_extracti128_si256(keep, 1));
+                    auto* prev = reinterpret_cast<__m256i*>(prev_edges_from + j + 4 * half);
+                    const auto* prev_through = reinterpret_cast<const __m256i*>(prev_edges_through + j + 4 * half);
+                    _mm256_storeu_si256(prev, _mm256_blendv_epi8(_mm256_loadu_si256(prev_through),
+                                                                 _mm256_loadu_si256(prev), keep_edges));
+                }
+            }
+#endif
+        }
+        for (; j < count; ++j) {
+            if (weights_through[j] == INFINITE_WEIGHT) {
+                continue; // для целочисленных весов сумма с INFINITE_WEIGHT переполнилась бы
+            }
+            const Weight candidate = weight_through + weights_through[j];
+            if (candidate < weights_from[j]) {
+                weights_from[j] = candidate;
+                prev_edges_from[j] = prev_edges_through[j];
+            }
+        }
+    }
+
+    // релаксирует строку from на отрезке столбцов [to_begin, to_end) через вершину through
+    void RelaxRoute(VertexId vertex_from, VertexId vertex_through, VertexId to_begin, VertexId to_end) {
+        const Weight weight_through = weights_[GetIndex(vertex_from, vertex_through)];
+        if (weight_through == INFINITE_WEIGHT) {
+            return;
+        }
+        const size_t from_index = GetIndex(vertex_from, to_begin);
+        const size_t through_index = GetIndex(vertex_through, to_begin);
+        RelaxRow(weights_.data() + from_index, prev_edges_.data() + from_index,
+                 weights_.data() + through_index, prev_edges_.data() + through_index,
+                 weight_through, to_end - to_begin);
+    }
+
+    void RelaxRoutesInternalDataThroughVertex(VertexId vertex_through) {
+        for (VertexId vertex_from = 0; vertex_from < vertex_count_; ++vertex_from) {
+            RelaxRoute(vertex_from, vertex_through, 0, vertex_count_);
+        }
+    }
+
+    // релаксирует маршруты блока (block_from, block_to) через вершины блока block_through
+    void RelaxBlock(size_t block_from, size_t block_to, size_t block_through) {
+        const VertexId through_end = std::min(vertex_count_, (block_through + 1) * BLOCK_SIZE);
+        const VertexId from_end = std::min(vertex_count_, (block_from + 1) * BLOCK_SIZE);
+        const VertexId to_end = std::min(vertex_count_, (block_to + 1) * BLOCK_SIZE);
+        for (VertexId vertex_through = block_through * BLOCK_SIZE; vertex_through < through_end; ++vertex_through) {
+            for (VertexId vertex_from = block_from * BLOCK_SIZE; vertex_from < from_end; ++vertex_from) {
+                RelaxRoute(vertex_from, vertex_through, block_to * BLOCK_SIZE, to_end);
+            }
+        }
+    }
+
+    // выполняет задачи task(0) .. task(task_count - 1), распределяя их по потокам
+    template <typename Task>
+    static void RunInParallel(size_t thread_count, size_t task_count, const Task& task) {
+        const size_t worker_count = std::min(thread_count, task_count);
+        std::vector<std::thread> workers;
+        workers.reserve(worker_count);
+        for (size_t worker = 0; worker < worker_count; ++worker) {
+            workers.emplace_back([worker, worker_count, task_count, &task] {
+                for (size_t task_id = worker; task_id < task_count; task_id += worker_count) {
+                    task(task_id);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
         }
     }
 
-    void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-            if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-                for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                    if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                        RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
+    /*
+    блочный Флойд-Уоршелл: блоки, не зависящие друг от друга на текущей фазе, считаются параллельно.
+    Потоки создаются один раз на всё построение и ждут друг друга на барьере после каждой фазы
+    */
+    void RelaxRoutesInternalDataBlocked(size_t thread_count) {
+        const size_t block_count = (vertex_count_ + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const size_t worker_count = std::max<size_t>(1, std::min(thread_count, 2 * block_count));
+        Barrier barrier(worker_count);
+        const auto relax_blocks = [&](size_t worker) {
+            for (size_t block_through = 0; block_through < block_count; ++block_through) {
+                // фаза 1: диагональный блок зависит только от себя
+                if (worker == 0) {
+                    RelaxBlock(block_through, block_through, block_through);
+                }
+                barrier.Wait();
+
+                // фаза 2: блоки строки и столбца диагонального блока
+                for (size_t task_id = worker; task_id < 2 * block_count; task_id += worker_count) {
+                    const size_t block = task_id / 2;
+                    if (block == block_through) {
+                        continue;
+                    }
+                    if (task_id % 2 == 0) {
+                        RelaxBlock(block_through, block, block_through);
+                    } else {
+                        RelaxBlock(block, block_through, block_through);
+                    }
+                }
+                barrier.Wait();
+
+                // фаза 3: остальные блоки зависят только от блоков строки и столбца
+                for (size_t block_from = worker; block_from < block_count; block_from += worker_count) {
+                    if (block_from == block_through) {
+                        continue;
+                    }
+                    for (size_t block_to = 0; block_to < block_count; ++block_to) {
+                        if (block_to != block_through) {
+                            RelaxBlock(block_from, block_to, block_through);
+                        }
                     }
                 }
+                barrier.Wait();
             }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(worker_count - 1);
+        for (size_t worker = 1; worker < worker_count; ++worker) {
+            workers.emplace_back(relax_blocks, worker);
+        }
+        relax_blocks(0);
+        for (auto& worker : workers) {
+            worker.join();
         }
     }
 
-    static constexpr Weight ZERO_WEIGHT{};
+    /*
+    расширяет таблицу до vertex_count вершин, маршрутов в новые вершины и из них нет. Таблица выделяется
+    с запасом строк и столбцов, поэтому следующие добавления вершин её не копируют
+    */
+    void ResizeTable(size_t vertex_count);
+
+    // строки first, first + step, ... до row_count после удаления рёбер
+    void RepairRows(const GraphChange& change, VertexId first, size_t step, size_t row_count);
+
+    // учитывает в таблице добавленные рёбра
+    void RelaxAddedEdges(const std::vector<AddedEdge>& added_edges);
+
     const Graph& graph_;
-    RoutesInternalData routes_internal_data_;
+    size_t vertex_count_;
+    size_t row_size_; // длина строки таблицы, не меньше vertex_count_
+    size_t thread_count_ = 1; // потоки построения и обновления таблицы
+    std::vector<Weight> weights_; // веса маршрутов from -> to, индекс from * row_size_ + to
+    std::vector<EdgeId> prev_edges_; // последние рёбра маршрутов from -> to
+    const Weight* weights_data_ = nullptr; // собственная или внешняя таблица весов
+    const EdgeId* prev_edges_data_ = nullptr; // собственная или внешняя таблица последних рёбер
 };
 
 template <typename Weight>
-Router<Weight>::Router(const Graph& graph)
+Router<Weight>::Router(const Graph& graph, size_t thread_count)
     : graph_(graph)
-    , routes_internal_data_(graph.GetVertexCount(),
-                            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
+    , vertex_count_(graph.GetVertexCount())
+    , row_size_(vertex_count_)
+    , thread_count_(std::max<size_t>(thread_count, 1))
+    , weights_(vertex_count_ * vertex_count_, INFINITE_WEIGHT)
+    , prev_edges_(vertex_count_ * vertex_count_, NO_EDGE)
 {
     InitializeRoutesInternalData(graph);
 
-    const size_t vertex_count = graph.GetVertexCount();
-    for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-        RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+    if (thread_count > 1) {
+        RelaxRoutesInternalDataBlocked(thread_count);
+    } else {
+        for (VertexId vertex_through = 0; vertex_through < vertex_count_; ++vertex_through) {
+            RelaxRoutesInternalDataThroughVertex(vertex_through);
+        }
+    }
+    weights_data_ = weights_.data();
+    prev_edges_data_ = prev_edges_.data();
+}
+
+template <typename Weight>
+Router<Weight>::Router(const Graph& graph, const Weight* weights, const EdgeId* prev_edges)
+    : graph_(graph)
+    , vertex_count_(graph.GetVertexCount())
+    , row_size_(vertex_count_)
+    , weights_data_(weights)
+    , prev_edges_data_(prev_edges) {
+}
+
+template <typename Weight>
+bool Router<Weight>::UpdateGraph(const std::vector<EdgeId>& edge_ids, EdgeId first_added_edge) {
+    if (weights_data_ != weights_.data()) {
+        return false; // внешняя таблица только для чтения
+    }
+    const size_t old_vertex_count = vertex_count_;
+    if (graph_.GetVertexCount() != vertex_count_) {
+        ResizeTable(graph_.GetVertexCount());
+    }
+
+    GraphChange change{ edge_ids, first_added_edge, std::vector<VertexId>(graph_.GetEdgeCount()), {}, {} };
+    std::vector<AddedEdge> added_edges;
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        for (const auto& arc : graph_.GetArcs(vertex)) {
+            if (arc.weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+            change.edge_froms[arc.edge_id] = vertex;
+            if (arc.edge_id >= first_added_edge) {
+                added_edges.push_back({ vertex, arc });
+            }
+        }
+    }
+
+    if (std::find(edge_ids.begin(), edge_ids.end(), Graph::REMOVED_EDGE) != edge_ids.end()) {
+        // входящие дуги прежних рёбер сортировкой подсчётом по концу
+        change.in_offsets.assign(vertex_count_ + 1, 0);
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            for (const auto& arc : graph_.GetArcs(vertex)) {
+                if (arc.edge_id < first_added_edge) {
+                    ++change.in_offsets[arc.to + 1];
+                }
+            }
+        }
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            change.in_offsets[vertex + 1] += change.in_offsets[vertex];
+        }
+        std::vector<size_t> next_positions(change.in_offsets.begin(), change.in_offsets.end() - 1);
+        change.in_arcs.resize(change.in_offsets.back());
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            for (const auto& arc : graph_.GetArcs(vertex)) {
+                if (arc.edge_id < first_added_edge) {
+                    change.in_arcs[next_positions[arc.to]++] = { vertex, arc.edge_id, arc.weight };
+                }
+            }
+        }
+
+        // строки новых вершин ещё пусты
+        RunInParallel(thread_count_, thread_count_, [&](size_t worker) {
+            RepairRows(change, worker, thread_count_, old_vertex_count);
+        });
     }
+    if (!added_edges.empty()) {
+        RelaxAddedEdges(added_edges);
+    }
+    weights_data_ = weights_.data();
+    prev_edges_data_ = prev_edges_.data();
+    return true;
+}
+
+template <typename Weight>
+void Router<Weight>::ResizeTable(size_t vertex_count) {
+    if (vertex_count > row_size_) {
+        // запас в 1/16 числа вершин
+        const size_t row_size = vertex_count + vertex_count / 16;
+        std::vector<Weight> weights(row_size * row_size, INFINITE_WEIGHT);
+        std::vector<EdgeId> prev_edges(row_size * row_size, NO_EDGE);
+        for (VertexId from = 0; from < vertex_count_; ++from) {
+            std::copy_n(weights_.begin() + GetIndex(from, 0), vertex_count_, weights.begin() + from * row_size);
+            std::copy_n(prev_edges_.begin() + GetIndex(from, 0), vertex_count_, prev_edges.begin() + from * row_size);
+        }
+        row_size_ = row_size;
+        weights_ = std::move(weights);
+        prev_edges_ = std::move(prev_edges);
+    }
+
+    // строки и столбцы запаса не заполнялись: маршрутов нет
+    for (VertexId vertex = vertex_count_; vertex < vertex_count; ++vertex) {
+        weights_[GetIndex(vertex, vertex)] = ZERO_WEIGHT;
+    }
+    vertex_count_ = vertex_count;
+}
+
+template <typename Weight>
+void Router<Weight>::RepairRows(const GraphChange& change, VertexId first, size_t step, size_t row_count) {
+    enum : uint8_t { UNKNOWN, KEPT, AFFECTED };
+    std::vector<uint8_t> states(vertex_count_);
+    std::vector<VertexId> path;
+    std::vector<VertexId> affected;
+    for (VertexId from = first; from < row_count; from += step) {
+        Weight* weights = weights_.data() + GetIndex(from, 0);
+        EdgeId* prev_edges = prev_edges_.data() + GetIndex(from, 0);
+
+        // без удалённых рёбер в строке меняются только id рёбер
+        const bool has_removed_edges = std::any_of(prev_edges, prev_edges + vertex_count_, [&change](EdgeId edge_id) {
+            return edge_id != NO_EDGE && change.edge_ids[edge_id] == Graph::REMOVED_EDGE;
+        });
+        if (!has_removed_edges) {
+            for (VertexId to = 0; to < vertex_count_; ++to) {
+                if (prev_edges[to] != NO_EDGE) {
+                    prev_edges[to] = change.edge_ids[prev_edges[to]];
+                }
+            }
+            continue;
+        }
+
+        // маршрут затронут, если на нём есть удалённое ребро: вершина наследует состояние начала последнего ребра
+        std::fill(states.begin(), states.end(), UNKNOWN);
+        for (VertexId to = 0; to < vertex_count_; ++to) {
+            VertexId vertex = to;
+            while (states[vertex] == UNKNOWN) {
+                const EdgeId edge_id = prev_edges[vertex];
+                if (edge_id == NO_EDGE) {
+                    states[vertex] = KEPT; // начало строки или нет маршрута
+                } else if (change.edge_ids[edge_id] == Graph::REMOVED_EDGE) {
+                    states[vertex] = AFFECTED;
+                } else {
+                    path.push_back(vertex);
+                    vertex = change.edge_froms[change.edge_ids[edge_id]];
+                }
+            }
+            for (const VertexId path_vertex : path) {
+                states[path_vertex] = states[vertex];
+            }
+            path.clear();
+        }
+
+        affected.clear();
+        for (VertexId to = 0; to < vertex_count_; ++to) {
+            if (states[to] == AFFECTED) {
+                weights[to] = INFINITE_WEIGHT;
+                prev_edges[to] = NO_EDGE;
+                affected.push_back(to);
+            } else if (prev_edges[to] != NO_EDGE) {
+                prev_edges[to] = change.edge_ids[prev_edges[to]];
+            }
+        }
+
+        // затронутые вершины достигаются от незатронутых, дальше поиск идёт только по затронутым
+        Queue queue;
+        for (const VertexId vertex : affected) {
+            for (size_t i = change.in_offsets[vertex]; i < change.in_offsets[vertex + 1]; ++i) {
+                const InArc& in_arc = change.in_arcs[i];
+                if (states[in_arc.from] == KEPT && weights[in_arc.from] != INFINITE_WEIGHT
+                    && weights[in_arc.from] + in_arc.weight < weights[vertex]) {
+                    weights[vertex] = weights[in_arc.from] + in_arc.weight;
+                    prev_edges[vertex] = in_arc.edge_id;
+                }
+            }
+            if (weights[vertex] != INFINITE_WEIGHT) {
+                queue.push({ weights[vertex], vertex });
+            }
+        }
+        while (!queue.empty()) {
+            const auto [weight, vertex] = queue.top();
+            queue.pop();
+            if (weights[vertex] < weight) {
+                continue; // устаревший элемент кучи
+            }
+            for (const auto& arc : graph_.GetArcs(vertex)) {
+                if (arc.edge_id >= change.first_added_edge || states[arc.to] != AFFECTED) {
+                    continue;
+                }
+                const Weight candidate = weight + arc.weight;
+                if (candidate < weights[arc.to]) {
+                    weights[arc.to] = candidate;
+                    prev_edges[arc.to] = arc.edge_id;
+                    queue.push({ candidate, arc.to });
+                }
+            }
+        }
+    }
+}
+
+template <typename Weight>
+void Router<Weight>::RelaxAddedEdges(const std::vector<AddedEdge>& added_edges) {
+    constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+    // различные концы добавленных рёбер и копии их строк до обновления
+    std::vector<VertexId> ends;
+    std::vector<size_t> end_indexes(vertex_count_, NONE);
+    for (const auto& edge : added_edges) {
+        if (end_indexes[edge.arc.to] == NONE) {
+            end_indexes[edge.arc.to] = ends.size();
+            ends.push_back(edge.arc.to);
+        }
+    }
+    const size_t end_count = ends.size();
+    std::vector<Weight> end_weights(end_count * vertex_count_);
+    std::vector<EdgeId> end_prev_edges(end_count * vertex_count_);
+    for (size_t end = 0; end < end_count; ++end) {
+        std::copy_n(weights_.begin() + GetIndex(ends[end], 0), vertex_count_, end_weights.begin() + end * vertex_count_);
+        std::copy_n(prev_edges_.begin() + GetIndex(ends[end], 0), vertex_count_,
+                    end_prev_edges.begin() + end * vertex_count_);
+    }
+
+    // маршруты между концами в новом графе: прежние маршруты и добавленные рёбра, замкнутые Флойдом-Уоршеллом
+    std::vector<Weight> end_routes(end_count * end_count);
+    std::vector<EdgeId> end_route_edges(end_count * end_count);
+    for (size_t from = 0; from < end_count; ++from) {
+        const Weight* row = end_weights.data() + from * vertex_count_;
+        for (size_t to = 0; to < end_count; ++to) {
+            end_routes[from * end_count + to] = row[ends[to]];
+            end_route_edges[from * end_count + to] = end_prev_edges[from * vertex_count_ + ends[to]];
+        }
+        for (const auto& edge : added_edges) {
+            const size_t index = from * end_count + end_indexes[edge.arc.to];
+            if (row[edge.from] != INFINITE_WEIGHT && row[edge.from] + edge.arc.weight < end_routes[index]) {
+                end_routes[index] = row[edge.from] + edge.arc.weight;
+                end_route_edges[index] = edge.arc.edge_id;
+            }
+        }
+    }
+    for (size_t through = 0; through < end_count; ++through) {
+        for (size_t from = 0; from < end_count; ++from) {
+            const Weight weight_through = end_routes[from * end_count + through];
+            if (weight_through == INFINITE_WEIGHT) {
+                continue;
+            }
+            RelaxRow(end_routes.data() + from * end_count, end_route_edges.data() + from * end_count,
+                     end_routes.data() + through * end_count, end_route_edges.data() + through * end_count,
+                     weight_through, end_count);
+        }
+    }
+
+    RunInParallel(thread_count_, thread_count_, [&](size_t worker) {
+        std::vector<Weight> first_weights(end_count);
+        std::vector<EdgeId> first_edges(end_count);
+        std::vector<size_t> improved_ends;
+        for (VertexId from = worker; from < vertex_count_; from += thread_count_) {
+            Weight* weights = weights_.data() + GetIndex(from, 0);
+            EdgeId* prev_edges = prev_edges_.data() + GetIndex(from, 0);
+
+            // первый приход в конец: прежний маршрут или прежний маршрут и добавленное ребро
+            for (size_t end = 0; end < end_count; ++end) {
+                first_weights[end] = weights[ends[end]];
+                first_edges[end] = prev_edges[ends[end]];
+            }
+            for (const auto& edge : added_edges) {
+                const size_t end = end_indexes[edge.arc.to];
+                if (weights[edge.from] != INFINITE_WEIGHT && weights[edge.from] + edge.arc.weight < first_weights[end]) {
+                    first_weights[end] = weights[edge.from] + edge.arc.weight;
+                    first_edges[end] = edge.arc.edge_id;
+                }
+            }
+
+            // новые маршруты до концов: первый приход в конец и маршрут между концами
+            improved_ends.clear();
+            for (size_t to = 0; to < end_count; ++to) {
+                Weight best_weight = first_weights[to];
+                EdgeId best_edge = first_edges[to];
+                for (size_t end = 0; end < end_count; ++end) {
+                    const Weight route_weight = end_routes[end * end_count + to];
+                    if (end != to && first_weights[end] != INFINITE_WEIGHT && route_weight != INFINITE_WEIGHT
+                        && first_weights[end] + route_weight < best_weight) {
+                        best_weight = first_weights[end] + route_weight;
+                        best_edge = end_route_edges[end * end_count + to];
+                    }
+                }
+                if (best_weight < weights[ends[to]]) {
+                    weights[ends[to]] = best_weight;
+                    prev_edges[ends[to]] = best_edge;
+                    improved_ends.push_back(to);
+                }
+            }
+
+            // после последнего добавленного ребра маршрут идёт по прежним рёбрам
+            for (const size_t end : improved_ends) {
+                RelaxRow(weights, prev_edges, end_weights.data() + end * vertex_count_,
+                         end_prev_edges.data() + end * vertex_count_, weights[ends[end]], vertex_count_);
+            }
+        }
+    });
 }
 
 template <typename Weight>
 std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
                                                                              VertexId to) const {
-    const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-    if (!route_internal_data) {
+    if (from >= vertex_count_ || to >= vertex_count_) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    const Weight weight = weights_data_[GetIndex(from, to)];
+    if (weight == INFINITE_WEIGHT) {
         return std::nullopt;
     }
-    const Weight weight = route_internal_data->weight;
     std::vector<EdgeId> edges;
-    for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-         edge_id;
-         edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
+    for (EdgeId edge_id = prev_edges_data_[GetIndex(from, to)];
+         edge_id != NO_EDGE;
+         edge_id = prev_edges_data_[GetIndex(from, graph_.GetEdge(edge_id).from)])
     {
-        edges.push_back(*edge_id);
+        edges.push_back(edge_id);
     }
     std::reverse(edges.begin(), edges.end());
 
     return RouteInfo{weight, std::move(edges)};
 }
 
-}  // namespace graph
\ No newline at end of file
+template <typename Weight>
+std::vector<std::optional<Weight>> Router<Weight>::BuildWeights(const std::vector<VertexId>& from,
+                                                                const std::vector<VertexId>& to) const {
+    std::vector<std::optional<Weight>> weights;
+    weights.reserve(from.size() * to.size());
+    for (const VertexId vertex_from : from) {
+        for (const VertexId vertex_to : to) {
+            if (vertex_from >= vertex_count_ || vertex_to >= vertex_count_) {
+                throw std::out_of_range("Vertex id is out of range");
+            }
+            const Weight weight = weights_data_[GetIndex(vertex_from, vertex_to)];
+            weights.push_back(weight == INFINITE_WEIGHT ? std::nullopt : std::optional<Weight>(weight));
+        }
+    }
+    return weights;
+}
+
+}  // namespace graph
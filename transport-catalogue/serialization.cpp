@@ -0,0 +1,91 @@
+#include "serialization.h"
+
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SERIALIZATION_HAS_MMAP
+#endif
+
+
+namespace serialization {
+
+MappedFile::MappedFile(const std::string& path) {
+#if defined(SERIALIZATION_HAS_MMAP)
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+        void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) {
+            data_ = static_cast<const char*>(data);
+            size_ = static_cast<size_t>(file_stat.st_size);
+            is_mapped_ = true;
+        }
+    }
+    close(fd); // отображение остаётся действительным после закрытия дескриптора
+#else
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        return;
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        buffer_ = std::move(other.buffer_);
+        data_ = other.is_mapped_ ? other.data_ : buffer_.data();
+        size_ = other.size_;
+        is_mapped_ = other.is_mapped_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.is_mapped_ = false;
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::IsOpen() const {
+    return data_ != nullptr;
+}
+
+const char* MappedFile::GetData() const {
+    return data_;
+}
+
+size_t MappedFile::GetSize() const {
+    return size_;
+}
+
+void MappedFile::Close() {
+#if defined(SERIALIZATION_HAS_MMAP)
+    if (is_mapped_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    is_mapped_ = false;
+    buffer_.clear();
+}
+
+} // namespace serialization
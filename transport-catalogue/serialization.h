@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+
+/*
+двоичная запись и чтение данных маршрутизатора:
+файл отображается в память только для чтения, поэтому таблица маршрутов не копируется
+и страницы файла разделяются между процессами
+*/
+namespace serialization {
+
+// файл, отображённый в память только для чтения (без mmap файл читается в буфер целиком)
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    bool IsOpen() const;
+    const char* GetData() const;
+    size_t GetSize() const;
+
+private:
+    void Close();
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool is_mapped_ = false;
+    std::vector<char> buffer_; // используется, если отображение в память недоступно
+};
+
+/*
+контрольная сумма в духе FNV-1a (64 бита), но по 8-байтовым словам: файлы маршрутизатора проверяются
+целиком при каждой загрузке. Результат не зависит от того, какими частями добавлены байты
+*/
+class Checksum {
+public:
+    void AddBytes(const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        total_size_ += size;
+        if (pending_size_ != 0) { // дополнение неполного слова
+            const size_t count = std::min(size, sizeof(pending_) - pending_size_);
+            std::memcpy(pending_ + pending_size_, bytes, count);
+            pending_size_ += count;
+            bytes += count;
+            size -= count;
+            if (pending_size_ < sizeof(pending_)) {
+                return;
+            }
+            AddWord(pending_);
+            pending_size_ = 0;
+        }
+        for (; size >= sizeof(pending_); bytes += sizeof(pending_), size -= sizeof(pending_)) {
+            AddWord(bytes);
+        }
+        std::memcpy(pending_, bytes, size);
+        pending_size_ = size;
+    }
+
+    template <typename T>
+    void Add(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        AddBytes(&value, sizeof(T));
+    }
+
+    void AddString(std::string_view value) {
+        Add(static_cast<uint64_t>(value.size()));
+        AddBytes(value.data(), value.size());
+    }
+
+    // неполное слово дополняется нулями, длина в конце отличает его от слова с нулевыми байтами
+    uint64_t GetValue() const {
+        uint64_t word = 0;
+        std::memcpy(&word, pending_, pending_size_);
+        return (((hash_ ^ word) * PRIME) ^ total_size_) * PRIME;
+    }
+
+private:
+    static constexpr uint64_t PRIME = 1099511628211ULL;
+
+    void AddWord(const unsigned char* bytes) {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        hash_ = (hash_ ^ word) * PRIME;
+    }
+
+    uint64_t hash_ = 14695981039346656037ULL;
+    uint64_t total_size_ = 0;
+    unsigned char pending_[sizeof(uint64_t)] = {};
+    size_t pending_size_ = 0;
+};
+
+// запись значений в двоичный поток в порядке байтов платформы
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::ostream& output)
+        : output_(output) {
+    }
+
+    void WriteBytes(const void* data, size_t size) {
+        output_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        checksum_.AddBytes(data, size);
+        position_ += size;
+    }
+
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        WriteBytes(&value, sizeof(T));
+    }
+
+    void WriteString(std::string_view value) {
+        Write(static_cast<uint64_t>(value.size()));
+        WriteBytes(value.data(), value.size());
+    }
+
+    // дополняет поток нулями до позиции, кратной alignment
+    void Align(size_t alignment) {
+        static const char zeros[64] = {};
+        while (position_ % alignment != 0) {
+            const size_t count = std::min(alignment - position_ % alignment, sizeof(zeros));
+            WriteBytes(zeros, count);
+        }
+    }
+
+    size_t GetPosition() const {
+        return position_;
+    }
+
+    // завершает поток контрольной суммой всего записанного, её проверяет HasValidChecksum
+    void WriteChecksum() {
+        Write(checksum_.GetValue());
+    }
+
+private:
+    std::ostream& output_;
+    size_t position_ = 0;
+    Checksum checksum_;
+};
+
+// проверяет контрольную сумму, записанную WriteChecksum в последние 8 байт данных
+inline bool HasValidChecksum(const char* data, size_t size) {
+    uint64_t expected;
+    if (size < sizeof(expected)) {
+        return false;
+    }
+    std::memcpy(&expected, data + size - sizeof(expected), sizeof(expected));
+    Checksum checksum;
+    checksum.AddBytes(data, size - sizeof(expected));
+    return checksum.GetValue() == expected;
+}
+
+// чтение значений из буфера с проверкой границ
+class BinaryReader {
+public:
+    BinaryReader(const char* data, size_t size)
+        : data_(data)
+        , size_(size) {
+    }
+
+    template <typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, Skip(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string ReadString() {
+        const auto size = Read<uint64_t>();
+        const char* data = Skip(size);
+        return std::string(data, size);
+    }
+
+    // пропускает size байт и возвращает указатель на их начало
+    const char* Skip(size_t size) {
+        if (size > size_ - position_) {
+            throw std::runtime_error("Unexpected end of serialized data");
+        }
+        const char* data = data_ + position_;
+        position_ += size;
+        return data;
+    }
+
+    void Align(size_t alignment) {
+        Skip((alignment - position_ % alignment) % alignment);
+    }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t position_ = 0;
+};
+
+} // namespace serialization
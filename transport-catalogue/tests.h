@@ -4,10 +4,23 @@
 #include "domain.h"
 #include "graph.h"
 #include "router.h"
+#include "dijkstra_router.h"
+#include "ch_router.h"
+#include "hub_label_router.h"
+#include "lru_cache.h"
 #include "test_framework.h"
 #include "transport_catalogue.h"
 #include "transport_router.h"
 #include "map_renderer.h"
+#include "request_handler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <tuple>
 
 
 // тесты заполнения базы данных
@@ -226,6 +239,50 @@ void TestGetStopInfo() {
     ASSERT(!stop_info_new_york_city.has_value());
 }
 
+// псевдослучайный граф из edge_count рёбер весом до 20 (есть нулевые веса и петли), одинаковый для одного seed
+graph::DirectedWeightedGraph<size_t> MakeRandomGraph(uint64_t seed, size_t vertex_count, size_t edge_count) {
+    // линейный конгруэнтный генератор для воспроизводимого набора рёбер
+    uint64_t state = seed;
+    const auto next_random = [&state](size_t bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<size_t>((state >> 33) % bound);
+    };
+    graph::DirectedWeightedGraph<size_t> graph(vertex_count);
+    for (size_t i = 0; i < edge_count; ++i) {
+        graph.AddEdge({next_random(vertex_count), next_random(vertex_count), next_random(20)});
+    }
+    return graph;
+}
+
+/*
+маршруты router из каждой row_step-й вершины во все совпадают по наличию и весу с маршрутами reference,
+а рёбра маршрута образуют путь from -> to графа с тем же весом
+*/
+template <typename Weight>
+void AssertRoutesMatch(const graph::RouterBase<Weight>& router, const graph::RouterBase<Weight>& reference,
+                       const graph::DirectedWeightedGraph<Weight>& graph, size_t row_step = 1) {
+    for (graph::VertexId from = 0; from < graph.GetVertexCount(); from += row_step) {
+        for (graph::VertexId to = 0; to < graph.GetVertexCount(); ++to) {
+            const auto expected = reference.BuildRoute(from, to);
+            const auto route = router.BuildRoute(from, to);
+            ASSERT_EQUAL(route.has_value(), expected.has_value());
+            if (!route) {
+                continue;
+            }
+            ASSERT_EQUAL(route->weight, expected->weight);
+            Weight weight{};
+            graph::VertexId vertex = from;
+            for (const auto edge_id : route->edges) {
+                ASSERT_EQUAL(graph.GetEdge(edge_id).from, vertex);
+                vertex = graph.GetEdge(edge_id).to;
+                weight = weight + graph.GetEdge(edge_id).weight;
+            }
+            ASSERT_EQUAL(vertex, to);
+            ASSERT_EQUAL(weight, expected->weight);
+        }
+    }
+}
+
 void TestGraphAndRouter() {
 
     // Список рёбер
@@ -248,8 +305,9 @@ void TestGraphAndRouter() {
     ASSERT_EQUAL(graph.GetVertexCount(), 3);
     ASSERT_EQUAL(graph.GetEdgeCount(), 6);
                                   
-    // Инициализируем Router
-    graph::Router<size_t> router(graph);
+    // Сжимаем граф и инициализируем Router
+    const graph::CompactGraph<size_t> compact_graph(graph);
+    graph::Router<size_t> router(compact_graph);
 
     // Строим оптимальные маршруты
     const auto route0 = router.BuildRoute(0,1).value();
@@ -285,6 +343,354 @@ void TestGraphAndRouter() {
     ASSERT_EQUAL(route5.edges[0], 5);
 }
 
+// проверка сжатого графа: дуги вершин в порядке id рёбер, рёбра восстанавливаются по id
+void TestCompactGraph() {
+    graph::DirectedWeightedGraph<size_t> graph(5);
+    for (const auto& e : { graph::Edge<size_t>{2, 1, 4}, graph::Edge<size_t>{0, 1, 3},
+                           graph::Edge<size_t>{2, 0, 8}, graph::Edge<size_t>{4, 4, 1},
+                           graph::Edge<size_t>{0, 2, 6}, graph::Edge<size_t>{2, 1, 5} }) {
+        graph.AddEdge(e);
+    }
+
+    const graph::CompactGraph<size_t> compact_graph(graph);
+    ASSERT_EQUAL(compact_graph.GetVertexCount(), 5);
+    ASSERT_EQUAL(compact_graph.GetEdgeCount(), 6);
+
+    // дуги совпадают со списками смежности исходного графа (вершины 1 и 3 без дуг)
+    for (graph::VertexId vertex = 0; vertex < graph.GetVertexCount(); ++vertex) {
+        std::vector<graph::EdgeId> edge_ids;
+        for (const auto& arc : compact_graph.GetArcs(vertex)) {
+            const auto& edge = graph.GetEdge(arc.edge_id);
+            ASSERT_EQUAL(edge.from, vertex);
+            ASSERT_EQUAL(edge.to, arc.to);
+            ASSERT_EQUAL(edge.weight, arc.weight);
+            edge_ids.push_back(arc.edge_id);
+        }
+        const auto incident_edges = graph.GetIncidentEdges(vertex);
+        ASSERT(edge_ids == std::vector<graph::EdgeId>(incident_edges.begin(), incident_edges.end()));
+    }
+
+    for (graph::EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        const auto edge = compact_graph.GetEdge(edge_id);
+        ASSERT_EQUAL(edge.from, graph.GetEdge(edge_id).from);
+        ASSERT_EQUAL(edge.to, graph.GetEdge(edge_id).to);
+        ASSERT_EQUAL(edge.weight, graph.GetEdge(edge_id).weight);
+    }
+}
+
+// проверка удаления доминируемых параллельных рёбер: остаётся лучшее ребро пары вершин, при равенстве - первое
+void TestPruneDominatedEdges() {
+    graph::DirectedWeightedGraph<size_t> graph(3);
+    graph.AddEdge({0, 1, 5}); // 0
+    graph.AddEdge({0, 1, 3}); // 1 - лучшее 0 -> 1
+    graph.AddEdge({1, 2, 4}); // 2 - первое из равных 1 -> 2
+    graph.AddEdge({0, 1, 3}); // 3
+    graph.AddEdge({1, 2, 4}); // 4
+    graph.AddEdge({2, 0, 1}); // 5
+    graph.AddEdge({1, 0, 9}); // 6 - обратное ребро не параллельно 0 -> 1
+
+    std::vector<graph::EdgeId> kept_edges;
+    const auto pruned_graph = graph::PruneDominatedEdges(graph, kept_edges);
+    ASSERT_EQUAL(pruned_graph.GetEdgeCount(), 4);
+    ASSERT(kept_edges == std::vector<graph::EdgeId>({1, 2, 5, 6}));
+    for (graph::EdgeId edge_id = 0; edge_id < kept_edges.size(); ++edge_id) {
+        ASSERT_EQUAL(pruned_graph.GetEdge(edge_id).weight, graph.GetEdge(kept_edges[edge_id]).weight);
+    }
+
+    // два автобуса на перегоне A -> B: быстрый и медленный (через C), в графе остаётся одно ребро A -> B
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    for (const auto& name : {"A"s, "B"s, "C"s}) {
+        catalogue.AddStop({name, geo::Coordinates{}});
+    }
+    catalogue.AddBus({false, "1", {catalogue.FindStop("A"), catalogue.FindStop("B")}});
+    catalogue.AddBus({false, "2", {catalogue.FindStop("A"), catalogue.FindStop("C"), catalogue.FindStop("B")}});
+    catalogue.AddBus({false, "3", {catalogue.FindStop("A"), catalogue.FindStop("B")}});
+    catalogue.SetDistance("A"sv, "B"sv, 1000);
+    catalogue.SetDistance("A"sv, "C"sv, 1000);
+    catalogue.SetDistance("C"sv, "B"sv, 1000);
+    RouterSettings settings;
+    settings.bus_velocity_ = 30;
+    settings.bus_wait_time_ = 2;
+    TransportRouter router(catalogue);
+    router.SetRouterSettings(settings);
+    router.SetVertexCount(catalogue.GetStops().size());
+    router.BuildTransportRouter();
+
+    // A -> B и B -> A есть у всех трёх автобусов
+    ASSERT_EQUAL(router.GetPrunedEdgeCount(), 4);
+    const auto route = router.GetOptimalRoute("A"s, "B"s);
+    ASSERT(std::abs(route->time - 4.0) < 1e-9);
+    ASSERT_EQUAL(std::get<BusEdgeInfo>(route->route_edges[1]).bus, catalogue.FindBus("1")->id);
+}
+
+// проверка блочного многопоточного построения Router: результат совпадает с однопоточным
+void TestParallelRouter() {
+    const size_t vertex_count = 70; // два блока, второй неполный
+    graph::DirectedWeightedGraph<size_t> graph(vertex_count);
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        graph.AddEdge({vertex, (vertex + 1) % vertex_count, 1 + vertex % 5});
+        graph.AddEdge({vertex, (vertex * 7 + 3) % vertex_count, 10 + vertex % 3});
+    }
+
+    const graph::CompactGraph<size_t> compact_graph(graph);
+    const graph::Router<size_t> router(compact_graph);
+    const graph::Router<size_t> parallel_router(compact_graph, 4);
+    AssertRoutesMatch(parallel_router, router, graph, 7);
+}
+
+// проверка 32-битных целых весов (векторное ядро AVX2): те же маршруты, что у скалярного ядра для size_t
+void TestNarrowWeightRouter() {
+    const size_t vertex_count = 36; // не кратно ширине векторного ядра
+    const auto graph = MakeRandomGraph(3, vertex_count, 3 * vertex_count);
+    graph::DirectedWeightedGraph<uint32_t> narrow_graph(vertex_count);
+    for (graph::EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        const auto& edge = graph.GetEdge(edge_id);
+        narrow_graph.AddEdge({edge.from, edge.to, static_cast<uint32_t>(edge.weight)});
+    }
+
+    const graph::CompactGraph<size_t> compact_graph(graph);
+    const graph::CompactGraph<uint32_t> narrow_compact_graph(narrow_graph);
+    const graph::Router<size_t> router(compact_graph);
+    for (const size_t thread_count : {1, 4}) {
+        const graph::Router<uint32_t> narrow_router(narrow_compact_graph, thread_count);
+        for (graph::VertexId from = 0; from < vertex_count; ++from) {
+            for (graph::VertexId to = 0; to < vertex_count; ++to) {
+                const auto expected = router.BuildRoute(from, to);
+                const auto route = narrow_router.BuildRoute(from, to);
+                ASSERT_EQUAL(route.has_value(), expected.has_value());
+                if (route) {
+                    ASSERT_EQUAL(route->weight, expected->weight);
+                    ASSERT(route->edges == expected->edges);
+                }
+            }
+        }
+    }
+}
+
+// проверка постоянных потоков: каждый шаг выполняет задачи 0 .. worker_count - 1 ровно по разу, в том числе
+// при шаге из второго потока, пока пул занят
+void TestWorkerPool() {
+    graph::WorkerPool pool(3);
+    ASSERT_EQUAL(pool.GetThreadCount(), 3);
+    std::vector<size_t> counts(3, 0);
+    for (size_t step = 0; step < 50; ++step) {
+        pool.Run(step % 2 == 0 ? 3 : 2, [&counts](size_t worker) {
+            ++counts[worker];
+        });
+    }
+    ASSERT(counts == std::vector<size_t>({50, 50, 25}));
+
+    std::vector<size_t> outer_counts(3, 0);
+    std::vector<size_t> inner_counts(2, 0);
+    pool.Run(3, [&](size_t worker) {
+        ++outer_counts[worker];
+        if (worker == 1) {
+            std::thread([&] {
+                pool.Run(2, [&inner_counts](size_t inner_worker) {
+                    ++inner_counts[inner_worker];
+                });
+            }).join();
+        }
+    });
+    ASSERT(outer_counts == std::vector<size_t>({1, 1, 1}));
+    ASSERT(inner_counts == std::vector<size_t>({1, 1}));
+}
+
+// проверка таблицы последних рёбер: веса, восстановленные по рёбрам, совпадают с таблицей Router
+void TestPredecessorRouter() {
+    const size_t vertex_count = 30;
+    graph::DirectedWeightedGraph<size_t> graph(vertex_count + 1); // последняя вершина недостижима
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        graph.AddEdge({vertex, (vertex + 1) % vertex_count, 1 + vertex % 5});
+        graph.AddEdge({vertex, (vertex * 7 + 3) % vertex_count, 10 + vertex % 3});
+        graph.AddEdge({vertex, vertex, 0}); // петля не попадает в маршруты
+    }
+
+    const graph::CompactGraph<size_t> compact_graph(graph);
+    const graph::Router<size_t> router(compact_graph);
+    using NarrowRouter = graph::PredecessorRouter<size_t, uint16_t>;
+    const NarrowRouter predecessor_router(compact_graph, 3);
+    AssertRoutesMatch(predecessor_router, router, graph);
+    std::vector<graph::VertexId> vertices(graph.GetVertexCount());
+    for (graph::VertexId vertex = 0; vertex < vertices.size(); ++vertex) {
+        vertices[vertex] = vertex;
+    }
+    ASSERT(predecessor_router.BuildWeights(vertices, vertices) == router.BuildWeights(vertices, vertices));
+
+    // по числу рёбер выбирается 16-битная таблица
+    const auto narrow_router = graph::MakePredecessorRouter(compact_graph);
+    ASSERT(dynamic_cast<const NarrowRouter*>(narrow_router.get()) != nullptr);
+}
+
+// проверка совпадения маршрутов DijkstraRouter и Router (Флойд-Уоршелл)
+void TestDijkstraRouter() {
+
+    // граф с недостижимой вершиной 3 и параллельными рёбрами 0 -> 1
+    graph::DirectedWeightedGraph<size_t> graph(4);
+    for (const auto& e : { graph::Edge<size_t>{0, 1, 3}, graph::Edge<size_t>{0, 1, 2},
+                           graph::Edge<size_t>{0, 2, 6}, graph::Edge<size_t>{1, 2, 5},
+                           graph::Edge<size_t>{2, 0, 8}, graph::Edge<size_t>{2, 1, 4},
+                           graph::Edge<size_t>{3, 0, 1} }) {
+        graph.AddEdge(e);
+    }
+
+    const graph::CompactGraph<size_t> compact_graph(graph);
+    const graph::Router<size_t> router(compact_graph);
+    const graph::DijkstraRouter<size_t> dijkstra_router(compact_graph);
+
+    // веса и количество рёбер совпадают для всех пар вершин
+    for (graph::VertexId from = 0; from < graph.GetVertexCount(); ++from) {
+        for (graph::VertexId to = 0; to < graph.GetVertexCount(); ++to) {
+            const auto expected = router.BuildRoute(from, to);
+            const auto route = dijkstra_router.BuildRoute(from, to);
+            ASSERT_EQUAL(route.has_value(), expected.has_value());
+            if (route) {
+                ASSERT_EQUAL(route->weight, expected->weight);
+                ASSERT_EQUAL(route->edges.size(), expected->edges.size());
+            }
+        }
+    }
+
+    // выбирается более лёгкое из параллельных рёбер
+    ASSERT_EQUAL(dijkstra_router.BuildRoute(0, 1)->edges[0], 1);
+    ASSERT(!dijkstra_router.BuildRoute(0, 3).has_value());
+}
+
+// проверка маршрутов из одной вершины в несколько: результат совпадает с поиском по каждой паре
+void TestBuildRoutes() {
+
+    graph::DirectedWeightedGraph<size_t> graph(5);
+    for (const auto& e : { graph::Edge<size_t>{0, 1, 3}, graph::Edge<size_t>{0, 2, 6},
+                           graph::Edge<size_t>{1, 2, 2}, graph::Edge<size_t>{2, 3, 1},
+                           graph::Edge<size_t>{3, 1, 7}, graph::Edge<size_t>{4, 0, 1} }) {
+        graph.AddEdge(e);
+    }
+
+    const graph::CompactGraph<size_t> compact_graph(graph);
+    const graph::Router<size_t> router(compact_graph);
+    const graph::DijkstraRouter<size_t> dijkstra_router(compact_graph);
+
+    // цели с повтором, исходной и недостижимой вершиной
+    const std::vector<graph::VertexId> targets = {3, 1, 3, 0, 4, 2};
+    for (const graph::RouterBase<size_t>* base : { static_cast<const graph::RouterBase<size_t>*>(&router),
+                                                   static_cast<const graph::RouterBase<size_t>*>(&dijkstra_router) }) {
+        const auto routes = base->BuildRoutes(0, targets);
+        ASSERT_EQUAL(routes.size(), targets.size());
+        for (size_t i = 0; i < targets.size(); ++i) {
+            const auto expected = router.BuildRoute(0, targets[i]);
+            ASSERT_EQUAL(routes[i].has_value(), expected.has_value());
+            if (expected) {
+                ASSERT_EQUAL(routes[i]->weight, expected->weight);
+                ASSERT_EQUAL(routes[i]->edges.size(), expected->edges.size());
+            }
+        }
+    }
+    ASSERT_EQUAL(dijkstra_router.BuildRoutes(0, targets)[0]->weight, 6);
+    ASSERT(!dijkstra_router.BuildRoutes(0, targets)[4].has_value());
+}
+
+// проверка матрицы весов: все маршрутизаторы дают веса Router, повторы и недостижимые пары сохраняют позиции
+void TestBuildWeights() {
+    const size_t vertex_count = 60;
+    const auto graph = MakeRandomGraph(7, vertex_count, 2 * vertex_count);
+
+    const graph::CompactGraph<size_t> compact_graph(graph);
+    const graph::Router<size_t> router(compact_graph);
+    const graph::DijkstraRouter<size_t> dijkstra_router(compact_graph);
+    const graph::ContractionHierarchyRouter<size_t> ch_router(compact_graph);
+    const graph::HubLabelRouter<size_t> hub_label_router(compact_graph);
+
+    const std::vector<graph::VertexId> from = {0, 5, 17, 5, 42, 59};
+    const std::vector<graph::VertexId> to = {3, 0, 17, 33, 3, 58, 21};
+    for (const graph::RouterBase<size_t>* base : { static_cast<const graph::RouterBase<size_t>*>(&router),
+                                                   static_cast<const graph::RouterBase<size_t>*>(&dijkstra_router),
+                                                   static_cast<const graph::RouterBase<size_t>*>(&ch_router),
+                                                   static_cast<const graph::RouterBase<size_t>*>(&hub_label_router) }) {
+        const auto weights = base->BuildWeights(from, to);
+        ASSERT_EQUAL(weights.size(), from.size() * to.size());
+        for (size_t i = 0; i < from.size(); ++i) {
+            for (size_t j = 0; j < to.size(); ++j) {
+                const auto expected = router.BuildRoute(from[i], to[j]);
+                const auto& weight = weights[i * to.size() + j];
+                ASSERT_EQUAL(weight.has_value(), expected.has_value());
+                if (expected) {
+                    ASSERT_EQUAL(*weight, expected->weight);
+                }
+            }
+        }
+    }
+    ASSERT_EQUAL(*ch_router.BuildWeights({17}, {17})[0], 0);
+}
+
+// проверка A*: тот же оптимальный вес, что у Дейкстры, при меньшем числе просмотренных вершин
+void TestAStarRouter() {
+
+    // вершины на прямой с координатой, равной id; рёбра в обе стороны между соседями
+    const size_t vertex_count = 100;
+    graph::DirectedWeightedGraph<size_t> graph(vertex_count);
+    for (size_t vertex = 0; vertex + 1 < vertex_count; ++vertex) {
+        graph.AddEdge({vertex, vertex + 1, 1});
+        graph.AddEdge({vertex + 1, vertex, 1});
+    }
+
+    const graph::CompactGraph<size_t> compact_graph(graph);
+    const graph::DijkstraRouter<size_t> dijkstra_router(compact_graph);
+    const graph::AStarRouter<size_t> astar_router(compact_graph, [](size_t vertex, size_t target) {
+        return vertex > target ? vertex - target : target - vertex;
+    });
+
+    graph::SearchStats dijkstra_stats;
+    graph::SearchStats astar_stats;
+    const auto expected = dijkstra_router.BuildRouteWithStats(50, 90, dijkstra_stats);
+    const auto route = astar_router.BuildRouteWithStats(50, 90, astar_stats);
+    ASSERT(route.has_value());
+    ASSERT_EQUAL(route->weight, expected->weight);
+    ASSERT_EQUAL(route->edges.size(), 40);
+
+    // Дейкстра расходится в обе стороны, A* идёт только к цели
+    ASSERT_EQUAL(astar_stats.settled_vertices, 41);
+    ASSERT(dijkstra_stats.settled_vertices > 2 * astar_stats.settled_vertices - 5);
+    ASSERT(dijkstra_stats.relaxed_edges > astar_stats.relaxed_edges);
+}
+
+// проверка совпадения маршрутов ContractionHierarchyRouter и Router на псевдослучайном графе
+void TestContractionHierarchyRouter() {
+    const size_t vertex_count = 60;
+    const auto graph = MakeRandomGraph(42, vertex_count, 4 * vertex_count);
+
+    const graph::CompactGraph<size_t> compact_graph(graph);
+    const graph::Router<size_t> router(compact_graph);
+    const graph::ContractionHierarchyRouter<size_t> ch_router(compact_graph);
+
+    // веса совпадают, а раскрытые сокращения образуют связный путь из исходных рёбер
+    AssertRoutesMatch(ch_router, router, graph);
+}
+
+// проверка меток-хабов: веса и раскрытые пути совпадают с Router
+void TestHubLabelRouter() {
+    const size_t vertex_count = 60;
+    const auto graph = MakeRandomGraph(7, vertex_count, 3 * vertex_count);
+
+    const graph::CompactGraph<size_t> compact_graph(graph);
+    const graph::Router<size_t> router(compact_graph);
+    const graph::HubLabelRouter<size_t> hub_router(compact_graph);
+
+    AssertRoutesMatch(hub_router, router, graph);
+
+    // маршрутизатор по внешним массивам меток отвечает так же
+    const size_t count = hub_router.GetVertexCount();
+    const graph::HubLabelRouter<size_t> view_router(compact_graph, hub_router.GetHubVertices(),
+        hub_router.GetOutOffsets(), hub_router.GetOutLabels(), hub_router.GetInOffsets(), hub_router.GetInLabels());
+    ASSERT_EQUAL(view_router.GetLabelStats().total_entries, hub_router.GetLabelStats().total_entries);
+    ASSERT_EQUAL(view_router.BuildRoute(0, count - 1).has_value(), router.BuildRoute(0, count - 1).has_value());
+
+    // в метке не больше одного элемента на вершину
+    const auto stats = hub_router.GetLabelStats();
+    ASSERT(stats.total_entries > 0);
+    ASSERT(stats.max_entries <= vertex_count);
+}
+
 void TestSphereProjector() {
 
     // Задаём размер карты и отступ от краёв
@@ -414,6 +820,884 @@ void GetOptimalRoute() {
     ASSERT_EQUAL(route_AE.size(), 4);
 }
 
+// проверка модели графа ROUTE_PATTERNS: те же маршруты, что и в STOP_PAIRS, при линейном числе рёбер
+void TestRoutePatternGraph() {
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    catalogue.AddStop({"A", {55.611087, 37.20829}});
+    catalogue.AddStop({"B", {55.595884, 37.209755}});
+    catalogue.AddStop({"C", {55.632761, 37.333324}});
+    catalogue.AddStop({"D", {55.574371, 37.6517}});
+    catalogue.AddStop({"E", {55.581065, 37.64839}});
+    catalogue.AddBus({false, "14", {catalogue.FindStop("A"), catalogue.FindStop("B"), catalogue.FindStop("C"),
+                                    catalogue.FindStop("D")}});
+    catalogue.AddBus({true, "24", {catalogue.FindStop("E"), catalogue.FindStop("D"), catalogue.FindStop("B"),
+                                   catalogue.FindStop("E")}});
+    catalogue.SetDistance("A"sv, "B"sv, 2000);
+    catalogue.SetDistance("B"sv, "C"sv, 3000);
+    catalogue.SetDistance("C"sv, "B"sv, 3500);
+    catalogue.SetDistance("C"sv, "D"sv, 1500);
+    catalogue.SetDistance("E"sv, "D"sv, 900);
+    catalogue.SetDistance("D"sv, "B"sv, 4100);
+    catalogue.SetDistance("B"sv, "E"sv, 2700);
+
+    RouterSettings settings;
+    settings.bus_velocity_ = 30;
+    settings.bus_wait_time_ = 4;
+    TransportRouter router(catalogue);
+    router.SetRouterSettings(settings);
+    router.SetVertexCount(catalogue.GetStops().size());
+    router.BuildTransportRouter();
+
+    settings.graph_model_ = GraphModel::ROUTE_PATTERNS;
+    TransportRouter pattern_router(catalogue);
+    pattern_router.SetRouterSettings(settings);
+    pattern_router.SetVertexCount(catalogue.GetStops().size());
+    pattern_router.BuildTransportRouter();
+
+    // совпадают время и элементы маршрута, включая число перегонов поездок
+    for (const auto& from : {"A"s, "B"s, "C"s, "D"s, "E"s}) {
+        for (const auto& to : {"A"s, "B"s, "C"s, "D"s, "E"s}) {
+            const auto expected = router.GetOptimalRoute(from, to);
+            const auto route = pattern_router.GetOptimalRoute(from, to);
+            ASSERT_EQUAL(route.has_value(), expected.has_value());
+            if (!route) {
+                continue;
+            }
+            ASSERT(std::abs(route->time - expected->time) < 1e-9);
+            ASSERT_EQUAL(route->route_edges.size(), expected->route_edges.size());
+            for (size_t i = 0; i < route->route_edges.size(); ++i) {
+                ASSERT_EQUAL(route->route_edges[i].index(), expected->route_edges[i].index());
+                if (std::holds_alternative<BusEdgeInfo>(route->route_edges[i])) {
+                    const auto& trip = std::get<BusEdgeInfo>(route->route_edges[i]);
+                    const auto& expected_trip = std::get<BusEdgeInfo>(expected->route_edges[i]);
+                    ASSERT_EQUAL(trip.bus, expected_trip.bus);
+                    ASSERT_EQUAL(trip.span_count, expected_trip.span_count);
+                    ASSERT(std::abs(trip.time - expected_trip.time) < 1e-9);
+                }
+            }
+        }
+    }
+}
+
+// проверка RAPTOR: те же маршруты, что у графовых маршрутизаторов, и ограничение числа пересадок
+void TestRaptorRouter() {
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    for (const auto& name : {"A"s, "B"s, "C"s, "E"s}) {
+        catalogue.AddStop({name, geo::Coordinates{}});
+    }
+    catalogue.AddBus({true, "297", {catalogue.FindStop("A"), catalogue.FindStop("B"), catalogue.FindStop("C"),
+                                    catalogue.FindStop("A")}});
+    catalogue.AddBus({false, "635", {catalogue.FindStop("B"), catalogue.FindStop("C"), catalogue.FindStop("E")}});
+    catalogue.SetDistance("A"sv, "B"sv, 2600);
+    catalogue.SetDistance("B"sv, "C"sv, 890);
+    catalogue.SetDistance("C"sv, "A"sv, 2500);
+    catalogue.SetDistance("C"sv, "B"sv, 1380);
+    catalogue.SetDistance("C"sv, "E"sv, 4650);
+
+    RouterSettings settings;
+    settings.bus_velocity_ = 40;
+    settings.bus_wait_time_ = 6;
+    TransportRouter router(catalogue);
+    router.SetRouterSettings(settings);
+    router.SetVertexCount(catalogue.GetStops().size());
+    router.BuildTransportRouter();
+
+    settings.router_type_ = RouterType::RAPTOR;
+    TransportRouter raptor_router(catalogue);
+    raptor_router.SetRouterSettings(settings);
+    raptor_router.SetVertexCount(catalogue.GetStops().size());
+    raptor_router.BuildTransportRouter();
+
+    const std::vector<std::string> stops = {"A"s, "B"s, "C"s, "E"s};
+    for (const auto& from : stops) {
+        const auto routes = raptor_router.GetOptimalRoutes(from, stops);
+        for (size_t i = 0; i < stops.size(); ++i) {
+            const auto expected = router.GetOptimalRoute(from, stops[i]);
+            const auto route = raptor_router.GetOptimalRoute(from, stops[i]);
+            ASSERT_EQUAL(route.has_value(), expected.has_value());
+            ASSERT_EQUAL(routes[i].has_value(), expected.has_value());
+            if (expected) {
+                ASSERT(std::abs(route->time - expected->time) < 1e-9);
+                ASSERT(std::abs(routes[i]->time - expected->time) < 1e-9);
+                ASSERT_EQUAL(route->route_edges.size(), expected->route_edges.size());
+            }
+        }
+    }
+    ASSERT(!raptor_router.GetOptimalRoute("A"s, "X"s).has_value());
+
+    // A -> E требует пересадки на B или C
+    settings.max_transfers_ = 0;
+    TransportRouter direct_router(catalogue);
+    direct_router.SetRouterSettings(settings);
+    direct_router.SetVertexCount(catalogue.GetStops().size());
+    direct_router.BuildTransportRouter();
+    ASSERT(!direct_router.GetOptimalRoute("A"s, "E"s).has_value());
+    ASSERT(std::abs(direct_router.GetOptimalRoute("A"s, "C"s)->time - 11.235) < 0.001);
+}
+
+// проверка матрицы времени маршрутов: для всех типов маршрутизаторов совпадает со временем запросов Route
+void TestTravelTimes() {
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    for (const auto& name : {"A"s, "B"s, "C"s, "E"s, "F"s}) {
+        catalogue.AddStop({name, geo::Coordinates{}});
+    }
+    catalogue.AddBus({true, "297", {catalogue.FindStop("A"), catalogue.FindStop("B"), catalogue.FindStop("C"),
+                                    catalogue.FindStop("A")}});
+    catalogue.AddBus({false, "635", {catalogue.FindStop("B"), catalogue.FindStop("C"), catalogue.FindStop("E")}});
+    catalogue.SetDistance("A"sv, "B"sv, 2600);
+    catalogue.SetDistance("B"sv, "C"sv, 890);
+    catalogue.SetDistance("C"sv, "A"sv, 2500);
+    catalogue.SetDistance("C"sv, "B"sv, 1380);
+    catalogue.SetDistance("C"sv, "E"sv, 4650);
+
+    // F без автобусов недостижима, X нет в справочнике
+    const std::vector<std::string> origins = {"A"s, "X"s, "E"s, "A"s, "F"s};
+    const std::vector<std::string> destinations = {"E"s, "A"s, "F"s, "X"s, "C"s};
+    for (const auto type : {RouterType::ALL_PAIRS, RouterType::DIJKSTRA, RouterType::CONTRACTION_HIERARCHY,
+                            RouterType::ASTAR, RouterType::RAPTOR, RouterType::HUB_LABELS}) {
+        RouterSettings settings;
+        settings.bus_velocity_ = 40;
+        settings.bus_wait_time_ = 6;
+        settings.router_type_ = type;
+        TransportRouter router(catalogue);
+        router.SetRouterSettings(settings);
+        router.SetVertexCount(catalogue.GetStops().size());
+        router.BuildTransportRouter();
+
+        const auto times = router.GetTravelTimes(origins, destinations);
+        ASSERT_EQUAL(times.size(), origins.size());
+        for (size_t i = 0; i < origins.size(); ++i) {
+            ASSERT_EQUAL(times[i].size(), destinations.size());
+            for (size_t j = 0; j < destinations.size(); ++j) {
+                const auto expected = router.GetOptimalRoute(origins[i], destinations[j]);
+                ASSERT_EQUAL(times[i][j].has_value(), expected.has_value());
+                if (expected) {
+                    ASSERT(std::abs(*times[i][j] - expected->time) < 1e-9);
+                }
+            }
+        }
+        ASSERT(times[0][0].has_value());
+        ASSERT(!times[4][4].has_value());
+    }
+}
+
+// проверка запроса Isochrone: достижимые остановки и время совпадают с запросами Route для всех моделей и типов
+void TestReachableStops() {
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    for (const auto& name : {"A"s, "B"s, "C"s, "E"s, "F"s}) {
+        catalogue.AddStop({name, geo::Coordinates{}});
+    }
+    catalogue.AddBus({true, "297", {catalogue.FindStop("A"), catalogue.FindStop("B"), catalogue.FindStop("C"),
+                                    catalogue.FindStop("A")}});
+    catalogue.AddBus({false, "635", {catalogue.FindStop("B"), catalogue.FindStop("C"), catalogue.FindStop("E")}});
+    catalogue.SetDistance("A"sv, "B"sv, 2600);
+    catalogue.SetDistance("B"sv, "C"sv, 890);
+    catalogue.SetDistance("C"sv, "A"sv, 2500);
+    catalogue.SetDistance("C"sv, "B"sv, 1380);
+    catalogue.SetDistance("C"sv, "E"sv, 4650);
+
+    const std::vector<std::string> stops = {"A"s, "B"s, "C"s, "E"s, "F"s};
+    for (const auto model : {GraphModel::STOP_PAIRS, GraphModel::ROUTE_PATTERNS}) {
+        for (const auto type : {RouterType::ALL_PAIRS, RouterType::DIJKSTRA, RouterType::RAPTOR}) {
+            RouterSettings settings;
+            settings.bus_velocity_ = 40;
+            settings.bus_wait_time_ = 6;
+            settings.router_type_ = type;
+            settings.graph_model_ = model;
+            TransportRouter router(catalogue);
+            router.SetRouterSettings(settings);
+            router.SetVertexCount(catalogue.GetStops().size());
+            router.BuildTransportRouter();
+
+            for (const double budget : {0.0, 11.235, 20.0, 100.0}) {
+                const auto reachable_stops = router.GetReachableStops("A"s, budget);
+                ASSERT(reachable_stops.has_value());
+                std::vector<std::string> expected_names;
+                for (const auto& stop : stops) {
+                    const auto route = router.GetOptimalRoute("A"s, stop);
+                    if (route && route->time <= budget + 1e-9) {
+                        expected_names.push_back(stop);
+                    }
+                }
+                ASSERT_EQUAL(reachable_stops->size(), expected_names.size());
+                double previous_time = 0.0;
+                for (const auto& [name, time] : *reachable_stops) {
+                    ASSERT(std::find(expected_names.begin(), expected_names.end(), name) != expected_names.end());
+                    ASSERT(std::abs(time - router.GetOptimalRoute("A"s, name)->time) < 1e-9);
+                    ASSERT(time >= previous_time);
+                    previous_time = time;
+                }
+            }
+            ASSERT_EQUAL(router.GetReachableStops("A"s, 0.0)->front().name, "A"s);
+            ASSERT(router.GetReachableStops("A"s, -1.0)->empty());
+            ASSERT(!router.GetReachableStops("X"s, 100.0).has_value());
+        }
+    }
+}
+
+// проверка кэша маршрутов: вытеснение давних элементов, счётчики и очистка при смене настроек маршрутизатора
+void TestRouteCache() {
+    lru_cache::LruCache<int, std::string> cache(2);
+    cache.Put(1, "one"s);
+    cache.Put(2, "two"s);
+    ASSERT_EQUAL(*cache.Get(1), "one"s); // 2 становится самым давним
+    cache.Put(3, "three"s);
+    ASSERT(!cache.Get(2).has_value());
+    ASSERT_EQUAL(*cache.Get(3), "three"s);
+    auto cache_stats = cache.GetStats();
+    ASSERT_EQUAL(cache_stats.hits, 2);
+    ASSERT_EQUAL(cache_stats.misses, 1);
+    ASSERT_EQUAL(cache_stats.evictions, 1);
+    ASSERT_EQUAL(cache_stats.size, 2);
+
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    for (const auto& name : {"A"s, "B"s, "C"s, "E"s}) {
+        catalogue.AddStop({name, geo::Coordinates{}});
+    }
+    catalogue.AddBus({true, "297", {catalogue.FindStop("A"), catalogue.FindStop("B"), catalogue.FindStop("C"),
+                                    catalogue.FindStop("A")}});
+    catalogue.SetDistance("A"sv, "B"sv, 2600);
+    catalogue.SetDistance("B"sv, "C"sv, 890);
+    catalogue.SetDistance("C"sv, "A"sv, 2500);
+
+    RouterSettings settings;
+    settings.bus_velocity_ = 40;
+    settings.bus_wait_time_ = 6;
+    settings.router_type_ = RouterType::DIJKSTRA;
+    settings.route_cache_capacity_ = 16;
+    TransportRouter router(catalogue);
+    router.SetRouterSettings(settings);
+    router.SetVertexCount(catalogue.GetStops().size());
+    router.BuildTransportRouter();
+
+    // повторный запрос не ищет маршрут, отсутствие маршрута тоже кэшируется
+    graph::SearchStats stats;
+    const auto route = router.GetOptimalRoute("A"s, "C"s, stats);
+    ASSERT(stats.settled_vertices > 0);
+    const auto cached_route = router.GetOptimalRoute("A"s, "C"s, stats);
+    ASSERT_EQUAL(stats.settled_vertices, 0);
+    ASSERT(std::abs(cached_route->time - route->time) < 1e-9);
+    ASSERT_EQUAL(cached_route->route_edges.size(), route->route_edges.size());
+    ASSERT(!router.GetOptimalRoute("A"s, "E"s).has_value());
+    ASSERT(!router.GetOptimalRoute("A"s, "E"s).has_value());
+    const auto routes = router.GetOptimalRoutes("A"s, {"C"s, "B"s, "X"s});
+    ASSERT(std::abs(routes[0]->time - route->time) < 1e-9);
+    ASSERT(routes[1].has_value());
+    ASSERT(!routes[2].has_value());
+    cache_stats = router.GetRouteCacheStats();
+    ASSERT_EQUAL(cache_stats.hits, 3);
+    ASSERT_EQUAL(cache_stats.misses, 3);
+    ASSERT_EQUAL(cache_stats.size, 3);
+
+    // новые настройки делают маршруты недействительными
+    settings.bus_wait_time_ = 10;
+    router.SetRouterSettings(settings);
+    ASSERT_EQUAL(router.GetRouteCacheStats().size, 0);
+    router.BuildTransportRouter();
+    ASSERT(std::abs(router.GetOptimalRoute("A"s, "C"s)->time - route->time - 4.0) < 1e-9);
+}
+
+// проверка фронта Парето по времени и числу поездок: быстрый маршрут с пересадкой и медленный прямой
+void TestParetoRoutes() {
+    // граф: 0 -> 2 напрямую (вес 10, одно отмеченное ребро; вес 12 без отмеченных) и через 1 (вес 4, два отмеченных)
+    graph::DirectedWeightedGraph<size_t> graph(4);
+    graph.AddEdge({0, 2, 10}); // 0 - отмечено
+    graph.AddEdge({0, 1, 2}); // 1 - отмечено
+    graph.AddEdge({1, 2, 2}); // 2 - отмечено
+    graph.AddEdge({0, 2, 12}); // 3 - не отмечено
+    const graph::CompactGraph<size_t> compact_graph(graph);
+    const auto is_counted = [](graph::EdgeId edge_id) {
+        return edge_id != 3;
+    };
+    graph::SearchStats stats;
+    auto routes = graph::SearchParetoRoutes(compact_graph, 0, 2, is_counted, graph::UNLIMITED_COUNT, stats);
+    ASSERT_EQUAL(routes.size(), 3);
+    ASSERT_EQUAL(routes[0].weight, 4);
+    ASSERT_EQUAL(routes[0].count, 2);
+    ASSERT(routes[0].edges == std::vector<graph::EdgeId>({1, 2}));
+    ASSERT_EQUAL(routes[1].weight, 10);
+    ASSERT_EQUAL(routes[1].count, 1);
+    ASSERT_EQUAL(routes[2].weight, 12);
+    ASSERT_EQUAL(routes[2].count, 0);
+    ASSERT(routes[2].edges == std::vector<graph::EdgeId>({3}));
+    ASSERT(graph::SearchParetoRoutes(compact_graph, 0, 3, is_counted, graph::UNLIMITED_COUNT, stats).empty());
+    routes = graph::SearchParetoRoutes(compact_graph, 0, 2, is_counted, 1, stats);
+    ASSERT_EQUAL(routes.size(), 2);
+    ASSERT_EQUAL(routes[0].weight, 10);
+
+    // остановки: прямой автобус A -> C и два автобуса через B
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    for (const auto& name : {"A"s, "B"s, "C"s}) {
+        catalogue.AddStop({name, geo::Coordinates{}});
+    }
+    catalogue.AddBus({false, "slow", {catalogue.FindStop("A"), catalogue.FindStop("C")}});
+    catalogue.AddBus({false, "1", {catalogue.FindStop("A"), catalogue.FindStop("B")}});
+    catalogue.AddBus({false, "2", {catalogue.FindStop("B"), catalogue.FindStop("C")}});
+    catalogue.SetDistance("A"sv, "C"sv, 10000);
+    catalogue.SetDistance("A"sv, "B"sv, 1000);
+    catalogue.SetDistance("B"sv, "C"sv, 1000);
+
+    RouterSettings settings;
+    settings.bus_velocity_ = 30;
+    settings.bus_wait_time_ = 2;
+    for (const auto router_type : {RouterType::ALL_PAIRS, RouterType::DIJKSTRA, RouterType::RAPTOR}) {
+        for (const auto graph_model : {GraphModel::STOP_PAIRS, GraphModel::ROUTE_PATTERNS}) {
+            settings.router_type_ = router_type;
+            settings.graph_model_ = graph_model;
+            settings.max_transfers_ = std::nullopt;
+            TransportRouter router(catalogue);
+            router.SetRouterSettings(settings);
+            router.SetVertexCount(catalogue.GetStops().size());
+            router.BuildTransportRouter();
+
+            const auto pareto_routes = router.GetParetoRoutes("A"s, "C"s);
+            ASSERT_EQUAL(pareto_routes->size(), 2);
+            ASSERT(std::abs((*pareto_routes)[0].time - 8.0) < 1e-9);
+            ASSERT_EQUAL((*pareto_routes)[0].route_edges.size(), 4);
+            ASSERT(std::abs((*pareto_routes)[1].time - 22.0) < 1e-9);
+            ASSERT_EQUAL((*pareto_routes)[1].route_edges.size(), 2);
+            ASSERT(std::abs(router.GetOptimalRoute("A"s, "C"s)->time - 8.0) < 1e-9);
+            ASSERT_EQUAL(router.GetParetoRoutes("A"s, "A"s)->size(), 1);
+            ASSERT(!router.GetParetoRoutes("A"s, "X"s).has_value());
+
+            // без пересадок остаётся только прямой маршрут
+            settings.max_transfers_ = 0;
+            TransportRouter direct_router(catalogue);
+            direct_router.SetRouterSettings(settings);
+            direct_router.SetVertexCount(catalogue.GetStops().size());
+            direct_router.BuildTransportRouter();
+            const auto direct_routes = direct_router.GetParetoRoutes("A"s, "C"s);
+            ASSERT_EQUAL(direct_routes->size(), 1);
+            ASSERT(std::abs((*direct_routes)[0].time - 22.0) < 1e-9);
+        }
+    }
+}
+
+// проверка альтернативных маршрутов: длинные и слишком похожие на выбранные отбрасываются
+void TestAlternativeRoutes() {
+    graph::DirectedWeightedGraph<double> graph(6);
+    graph.AddEdge({0, 1, 8}); // оптимальный 0 -> 1 -> 3, вес 10
+    graph.AddEdge({1, 3, 2});
+    graph.AddEdge({0, 2, 6}); // непересекающийся, вес 12
+    graph.AddEdge({2, 3, 6});
+    graph.AddEdge({0, 4, 15}); // длиннее полутора оптимальных
+    graph.AddEdge({4, 3, 15});
+    graph.AddEdge({1, 5, 1.5}); // вес 11, но 8 из 11 общие с оптимальным
+    graph.AddEdge({5, 3, 1.5});
+    const graph::CompactGraph<double> compact_graph(graph);
+    const graph::AlternativeRouteSearch<double> search(compact_graph);
+    const auto allow_all = [](const std::vector<graph::EdgeId>&) {
+        return true;
+    };
+    graph::SearchStats stats;
+
+    auto routes = search.FindRoutes(0, 3, 3, {}, allow_all, stats);
+    ASSERT_EQUAL(routes.size(), 2);
+    ASSERT(routes[0].edges == std::vector<graph::EdgeId>({0, 1}));
+    ASSERT(std::abs(routes[0].weight - 10.0) < 1e-9);
+    ASSERT(routes[1].edges == std::vector<graph::EdgeId>({2, 3}));
+    ASSERT(std::abs(routes[1].weight - 12.0) < 1e-9);
+    ASSERT(stats.settled_vertices > 0);
+
+    // с большим допуском сходства проходит и маршрут через 5, с большим удлинением - через 4
+    routes = search.FindRoutes(0, 3, 4, {2.0, 0.75}, allow_all, stats);
+    ASSERT_EQUAL(routes.size(), 3);
+    ASSERT(std::abs(routes[1].weight - 11.0) < 1e-9);
+    routes = search.FindRoutes(0, 3, 4, {3.0, 0.7}, allow_all, stats);
+    ASSERT_EQUAL(routes.size(), 3);
+    ASSERT(std::abs(routes[2].weight - 30.0) < 1e-9);
+
+    ASSERT_EQUAL(search.FindRoutes(0, 3, 1, {}, allow_all, stats).size(), 1);
+    ASSERT_EQUAL(search.FindRoutes(3, 3, 3, {}, allow_all, stats).size(), 1);
+    ASSERT(search.FindRoutes(3, 0, 3, {}, allow_all, stats).empty());
+    const auto avoid_vertex_2 = [&compact_graph](const std::vector<graph::EdgeId>& edges) {
+        return std::none_of(edges.begin(), edges.end(), [&compact_graph](graph::EdgeId edge_id) {
+            return compact_graph.GetEdge(edge_id).to == 2;
+        });
+    };
+    routes = search.FindRoutes(0, 3, 3, {3.0, 0.7}, avoid_vertex_2, stats);
+    ASSERT_EQUAL(routes.size(), 2);
+    ASSERT(std::abs(routes[1].weight - 30.0) < 1e-9);
+
+    // A -> C: автобусом x через B (6 минут) или с пересадкой в D с y на z (8.4 минуты);
+    // пересадка с x на x в B (8 минут) не предлагается
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    for (const auto& name : {"A"s, "B"s, "C"s, "D"s}) {
+        catalogue.AddStop({name, geo::Coordinates{}});
+    }
+    catalogue.AddBus({false, "x", {catalogue.FindStop("A"), catalogue.FindStop("B"), catalogue.FindStop("C")}});
+    catalogue.AddBus({false, "y", {catalogue.FindStop("A"), catalogue.FindStop("D")}});
+    catalogue.AddBus({false, "z", {catalogue.FindStop("D"), catalogue.FindStop("C")}});
+    catalogue.SetDistance("A"sv, "B"sv, 1000);
+    catalogue.SetDistance("B"sv, "C"sv, 1000);
+    catalogue.SetDistance("A"sv, "D"sv, 1200);
+    catalogue.SetDistance("D"sv, "C"sv, 1000);
+
+    RouterSettings settings;
+    settings.bus_velocity_ = 30;
+    settings.bus_wait_time_ = 2;
+    for (const auto router_type : {RouterType::ALL_PAIRS, RouterType::DIJKSTRA, RouterType::RAPTOR}) {
+        for (const auto graph_model : {GraphModel::STOP_PAIRS, GraphModel::ROUTE_PATTERNS}) {
+            settings.router_type_ = router_type;
+            settings.graph_model_ = graph_model;
+            TransportRouter router(catalogue);
+            router.SetRouterSettings(settings);
+            router.SetVertexCount(catalogue.GetStops().size());
+            router.BuildTransportRouter();
+
+            const auto alternatives = router.GetAlternativeRoutes("A"s, "C"s, 3);
+            ASSERT(std::abs((*alternatives)[0].time - 6.0) < 1e-9);
+            ASSERT(std::abs((*alternatives)[0].time - router.GetOptimalRoute("A"s, "C"s)->time) < 1e-9);
+            if (router_type == RouterType::RAPTOR) {
+                ASSERT_EQUAL(alternatives->size(), 1); // без графа - только оптимальный
+                continue;
+            }
+            ASSERT_EQUAL(alternatives->size(), 2);
+            ASSERT(std::abs((*alternatives)[1].time - 8.4) < 1e-9);
+            ASSERT_EQUAL(catalogue.GetBusName(std::get<domain::BusEdgeInfo>((*alternatives)[1].route_edges[1]).bus), "y"sv);
+            ASSERT_EQUAL(router.GetAlternativeRoutes("A"s, "C"s, 1)->size(), 1);
+            ASSERT(!router.GetAlternativeRoutes("A"s, "X"s, 3).has_value());
+        }
+    }
+}
+
+// линейный конгруэнтный генератор случайных справочников: следующее число из [0, bound)
+size_t NextRandom(uint32_t& state, size_t bound) {
+    state = state * 1103515245 + 12345;
+    return (state >> 16) % bound;
+}
+
+// stop_count остановок "S<i>" рядом друг с другом и bus_count автобусов "B<i>" из 3-6 случайных остановок, чётные - кольцевые
+void AddRandomStopsAndBuses(TransportCatalogue& catalogue, uint32_t& state, size_t stop_count, size_t bus_count) {
+    for (size_t i = 0; i < stop_count; ++i) {
+        catalogue.AddStop({"S"s + std::to_string(i),
+                           {55.6 + NextRandom(state, 100) * 1e-3, 37.5 + NextRandom(state, 100) * 1e-3}});
+    }
+    for (size_t bus = 0; bus < bus_count; ++bus) {
+        std::vector<const Stop*> route;
+        for (size_t i = 0, length = 3 + NextRandom(state, 4); i < length; ++i) {
+            route.push_back(catalogue.FindStop("S"s + std::to_string(NextRandom(state, stop_count))));
+        }
+        const bool is_roundtrip = bus % 2 == 0;
+        if (is_roundtrip) {
+            route.push_back(route.front());
+        }
+        catalogue.AddBus({is_roundtrip, "B"s + std::to_string(bus), route});
+    }
+}
+
+// расстояния 20000-25000 м от остановок справочника с номером от first_stop и до них, прежние не меняются
+void SetRandomDistances(TransportCatalogue& catalogue, uint32_t& state, size_t first_stop = 0) {
+    const auto& stops = catalogue.GetStops();
+    for (size_t i = 0; i < stops.size(); ++i) {
+        for (size_t j = 0; j < stops.size(); ++j) {
+            if (i >= first_stop || j >= first_stop) {
+                catalogue.SetDistance(stops[i].name, stops[j].name, 20000 + NextRandom(state, 5000));
+            }
+        }
+    }
+}
+
+// маршруты router всех пар остановок совпадают по наличию и времени с маршрутами построенного заново маршрутизатора
+void AssertRoutesMatchRebuilt(const transport_router::TransportRouter& router, TransportCatalogue& catalogue,
+                              const RouterSettings& settings) {
+    transport_router::TransportRouter expected_router(catalogue);
+    expected_router.SetRouterSettings(settings);
+    expected_router.SetVertexCount(catalogue.GetStops().size());
+    expected_router.BuildTransportRouter();
+    ASSERT_EQUAL(router.GetPrunedEdgeCount(), expected_router.GetPrunedEdgeCount());
+    for (const auto& from : catalogue.GetStops()) {
+        for (const auto& to : catalogue.GetStops()) {
+            const auto route = router.GetOptimalRoute(from.name, to.name);
+            const auto expected = expected_router.GetOptimalRoute(from.name, to.name);
+            ASSERT_EQUAL(route.has_value(), expected.has_value());
+            if (route) {
+                ASSERT(std::abs(route->time - expected->time) < 1e-9);
+            }
+        }
+    }
+}
+
+// проверка смены времени ожидания и скорости без перестроения графа: маршруты как у построенного заново
+void TestUpdateRouterSettings() {
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    uint32_t state = 7;
+    const size_t stop_count = 12;
+    AddRandomStopsAndBuses(catalogue, state, stop_count, 6);
+    SetRandomDistances(catalogue, state);
+
+    // ожидание, затем скорость, затем оба в 2 раза (все веса в 2 раза). Граф не перестраивается, предрасчёт
+    // повторяется при смене ожидания или скорости и не повторяется при умножении всех весов на одно число;
+    // целые веса при смене скорости перестраиваются вместе с графом
+    constexpr bool is_scalable = std::is_floating_point_v<RouteWeight>;
+    const std::vector<std::tuple<double, double, BuildStats>> steps = {
+        {6, 40, {1, 1}}, {3, 40, {1, 2}}, {3, 25, is_scalable ? BuildStats{1, 3} : BuildStats{2, 3}},
+        {6, 12.5, is_scalable ? BuildStats{1, 3} : BuildStats{3, 4}}};
+    for (const auto router_type : {RouterType::ALL_PAIRS, RouterType::ALL_PAIRS_COMPACT,
+                                   RouterType::CONTRACTION_HIERARCHY}) {
+        for (const auto graph_model : {GraphModel::STOP_PAIRS, GraphModel::ROUTE_PATTERNS}) {
+            RouterSettings settings;
+            settings.router_type_ = router_type;
+            settings.graph_model_ = graph_model;
+            settings.bus_wait_time_ = 6;
+            settings.bus_velocity_ = 40;
+            TransportRouter router(catalogue);
+            router.SetRouterSettings(settings);
+            router.SetVertexCount(stop_count);
+            router.BuildTransportRouter();
+
+            for (const auto& [wait_time, velocity, expected_stats] : steps) {
+                settings.bus_wait_time_ = wait_time;
+                settings.bus_velocity_ = velocity;
+                router.UpdateRouterSettings(settings);
+                ASSERT_EQUAL(router.GetBuildStats().graph_builds, expected_stats.graph_builds);
+                ASSERT_EQUAL(router.GetBuildStats().router_builds, expected_stats.router_builds);
+                AssertRoutesMatchRebuilt(router, catalogue, settings);
+            }
+        }
+    }
+}
+
+// проверка изменения справочника в построенном маршрутизаторе: маршруты как у маршрутизатора, построенного заново
+void TestIncrementalRouterUpdates() {
+    using namespace transport_router;
+    // таблица ALL_PAIRS обновляется, RAPTOR строится по справочнику, остальные маршрутизаторы
+    // одинаково строятся заново по изменённому графу - из них проверяются метки-хабы
+    for (const auto router_type : {RouterType::ALL_PAIRS, RouterType::HUB_LABELS, RouterType::RAPTOR}) {
+        for (const auto graph_model : {GraphModel::STOP_PAIRS, GraphModel::ROUTE_PATTERNS}) {
+            uint32_t state = 11;
+            TransportCatalogue catalogue;
+            AddRandomStopsAndBuses(catalogue, state, 8, 4);
+            SetRandomDistances(catalogue, state);
+            RouterSettings settings;
+            settings.router_type_ = router_type;
+            settings.graph_model_ = graph_model;
+            settings.bus_wait_time_ = 6;
+            settings.bus_velocity_ = 40;
+            TransportRouter router(catalogue);
+            router.SetRouterSettings(settings);
+            router.SetVertexCount(catalogue.GetStops().size());
+            router.BuildTransportRouter();
+
+            const auto add_bus = [&](const std::string& name, const std::vector<std::string>& stops, bool is_roundtrip) {
+                domain::Bus bus{is_roundtrip, name, {}};
+                for (const auto& stop : stops) {
+                    bus.route.push_back(catalogue.FindStop(stop));
+                }
+                catalogue.AddBus(bus);
+                router.AddBus(*catalogue.FindBus(name));
+                AssertRoutesMatchRebuilt(router, catalogue, settings);
+            };
+            const auto remove_bus = [&](const std::string& name) {
+                const domain::Bus* bus = catalogue.FindBus(name);
+                catalogue.RemoveBus(name);
+                ASSERT(catalogue.FindBus(name) == nullptr);
+                router.RemoveBus(*bus);
+                AssertRoutesMatchRebuilt(router, catalogue, settings);
+            };
+
+            // остановка без автобусов, затем автобус через неё и ещё одну новую остановку
+            catalogue.AddStop({"S8"s, {55.65, 37.55}});
+            SetRandomDistances(catalogue, state, 8);
+            router.AddStop(*catalogue.FindStop("S8"s));
+            AssertRoutesMatchRebuilt(router, catalogue, settings);
+            catalogue.AddStop({"S9"s, {55.66, 37.56}});
+            SetRandomDistances(catalogue, state, 9);
+            add_bus("B4"s, {"S8"s, "S3"s, "S9"s, "S7"s}, false);
+
+            // двойник маршрута B1: его рёбра вытеснены рёбрами B1 и возвращаются после удаления B1
+            std::vector<std::string> twin_stops;
+            for (const auto* stop : catalogue.FindBus("B1"s)->route) {
+                twin_stops.push_back(stop->name);
+            }
+            add_bus("B1 twin"s, twin_stops, false);
+            remove_bus("B1"s);
+            remove_bus("B0"s);
+            remove_bus("B4"s);
+            add_bus("B4"s, {"S9"s, "S0"s, "S8"s, "S9"s}, true);
+
+            // перегоны 20000-25000 м: ребро S10 -> S13 быстрее у экспресса, чем у W, и у W, чем у B5.
+            // Экспресс вытесняет ребро B5, W не добавляется, после удаления экспресса остаётся ребро W
+            for (size_t i = 10; i < 14; ++i) {
+                catalogue.AddStop({"S"s + std::to_string(i), {55.6 + i * 1e-3, 37.7}});
+            }
+            SetRandomDistances(catalogue, state, 10);
+            add_bus("B5"s, {"S10"s, "S11"s, "S12"s, "S13"s}, false);
+            add_bus("express"s, {"S10"s, "S13"s}, false);
+            add_bus("W"s, {"S10"s, "S11"s, "S13"s}, false);
+            remove_bus("express"s);
+        }
+    }
+}
+
+// проверка маршрутов по расписанию: пересадка с фактическим ожиданием, поездка без пересадок, рейсы прямых маршрутов обратно
+void TestTimetableRoute() {
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    for (const auto& name : {"A"s, "B"s, "C"s}) {
+        catalogue.AddStop({name, geo::Coordinates{}});
+    }
+    const auto add_bus = [&catalogue](const std::string& name, std::vector<std::string> stops,
+                                      std::vector<double> departures) {
+        domain::Bus bus{false, name, {}};
+        for (const auto& stop : stops) {
+            bus.route.push_back(catalogue.FindStop(stop));
+        }
+        bus.departures = std::move(departures);
+        catalogue.AddBus(bus);
+    };
+    add_bus("1"s, {"A"s, "B"s}, {10, 30});
+    add_bus("2"s, {"B"s, "C"s}, {13, 20});
+    add_bus("long"s, {"A"s, "B"s, "C"s}, {12});
+    catalogue.SetDistance("A"sv, "B"sv, 1000);
+    catalogue.SetDistance("B"sv, "C"sv, 1000);
+
+    RouterSettings settings;
+    settings.bus_velocity_ = 30; // 2 минуты на перегон
+    settings.bus_wait_time_ = 6; // по расписанию не используется
+    settings.router_type_ = RouterType::DIJKSTRA;
+    TransportRouter router(catalogue);
+    router.SetRouterSettings(settings);
+    router.SetVertexCount(catalogue.GetStops().size());
+    router.BuildTransportRouter();
+
+    // A в 10, B в 12, ожидание до 13, C в 15
+    graph::SearchStats stats;
+    auto route = router.GetTimetableRoute("A"s, "C"s, 0, stats);
+    ASSERT(std::abs(route->time - 15.0) < 1e-9);
+    ASSERT_EQUAL(route->route_edges.size(), 4);
+    ASSERT(std::abs(std::get<domain::WaitEdgeInfo>(route->route_edges[0]).time - 10.0) < 1e-9);
+    ASSERT(std::abs(std::get<domain::WaitEdgeInfo>(route->route_edges[2]).time - 1.0) < 1e-9);
+    ASSERT_EQUAL(catalogue.GetStopName(std::get<domain::WaitEdgeInfo>(route->route_edges[2]).stop), "B"sv);
+    ASSERT_EQUAL(catalogue.GetBusName(std::get<domain::BusEdgeInfo>(route->route_edges[3]).bus), "2"sv);
+    ASSERT(stats.relaxed_edges > 0);
+
+    // после 10 остаётся только рейс long в 12 без пересадок
+    route = router.GetTimetableRoute("A"s, "C"s, 11);
+    ASSERT(std::abs(route->time - 5.0) < 1e-9);
+    ASSERT_EQUAL(route->route_edges.size(), 2);
+    ASSERT_EQUAL(std::get<domain::BusEdgeInfo>(route->route_edges[1]).span_count, 2);
+
+    // обратные рейсы отправляются по прибытии на конечную: long из C в 16, A в 20
+    route = router.GetTimetableRoute("C"s, "A"s, 0);
+    ASSERT(std::abs(route->time - 20.0) < 1e-9);
+    ASSERT_EQUAL(route->route_edges.size(), 2);
+    ASSERT(std::abs(std::get<domain::WaitEdgeInfo>(route->route_edges[0]).time - 16.0) < 1e-9);
+    // после него: 2 из C в 22, B в 24, обратный рейс 1 из B в 32, A в 34
+    route = router.GetTimetableRoute("C"s, "A"s, 17);
+    ASSERT(std::abs(route->time - 17.0) < 1e-9);
+    ASSERT_EQUAL(route->route_edges.size(), 4);
+
+    // после последнего рейса, до той же остановки и без остановки
+    ASSERT(!router.GetTimetableRoute("A"s, "C"s, 40).has_value());
+    ASSERT(std::abs(router.GetTimetableRoute("A"s, "A"s, 40)->time) < 1e-9);
+    ASSERT(!router.GetTimetableRoute("A"s, "X"s, 0).has_value());
+
+    // маршрут без расписания не изменился
+    ASSERT(std::abs(router.GetOptimalRoute("A"s, "C"s)->time - 10.0) < 1e-9);
+}
+
+// проверка нумерации вершин по кривой Гильберта: порядок обхода четвертей и те же маршруты, что при нумерации справочника
+void TestHilbertVertexOrder() {
+    const geo::Coordinates min = {0.0, 0.0};
+    const geo::Coordinates max = {1.0, 1.0};
+    const uint64_t lower_left = geo::ComputeHilbertIndex({0.1, 0.1}, min, max);
+    const uint64_t upper_left = geo::ComputeHilbertIndex({0.9, 0.1}, min, max);
+    const uint64_t upper_right = geo::ComputeHilbertIndex({0.9, 0.9}, min, max);
+    const uint64_t lower_right = geo::ComputeHilbertIndex({0.1, 0.9}, min, max);
+    ASSERT(lower_left < upper_left && upper_left < upper_right && upper_right < lower_right);
+
+    // остановки добавлены вразброс по карте: соседние в справочнике далеко друг от друга
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    const std::vector<std::pair<std::string, geo::Coordinates>> stops = {
+        {"A"s, {55.60, 37.40}}, {"B"s, {55.90, 37.80}}, {"C"s, {55.61, 37.42}},
+        {"E"s, {55.88, 37.79}}, {"F"s, {55.75, 37.60}}, {"G"s, {55.62, 37.79}}
+    };
+    for (const auto& [name, coordinates] : stops) {
+        catalogue.AddStop({name, coordinates});
+    }
+    catalogue.AddBus({false, "1", {catalogue.FindStop("A"), catalogue.FindStop("C"), catalogue.FindStop("F"),
+                                   catalogue.FindStop("E"), catalogue.FindStop("B")}});
+    catalogue.AddBus({true, "2", {catalogue.FindStop("F"), catalogue.FindStop("G"), catalogue.FindStop("A"),
+                                  catalogue.FindStop("F")}});
+    catalogue.SetDistance("A"sv, "C"sv, 1500);
+    catalogue.SetDistance("C"sv, "F"sv, 4000);
+    catalogue.SetDistance("F"sv, "E"sv, 3500);
+    catalogue.SetDistance("E"sv, "B"sv, 900);
+    catalogue.SetDistance("F"sv, "G"sv, 5000);
+    catalogue.SetDistance("G"sv, "A"sv, 6000);
+    catalogue.SetDistance("A"sv, "F"sv, 4500);
+
+    RouterSettings settings;
+    settings.bus_velocity_ = 30;
+    settings.bus_wait_time_ = 3;
+    TransportRouter catalogue_router(catalogue);
+    catalogue_router.SetRouterSettings(settings);
+    catalogue_router.SetVertexCount(catalogue.GetStops().size());
+    catalogue_router.BuildTransportRouter();
+
+    settings.vertex_order_ = VertexOrder::HILBERT;
+    TransportRouter hilbert_router(catalogue);
+    hilbert_router.SetRouterSettings(settings);
+    hilbert_router.SetVertexCount(catalogue.GetStops().size());
+    hilbert_router.BuildTransportRouter();
+
+    for (const auto& [from, from_coordinates] : stops) {
+        for (const auto& [to, to_coordinates] : stops) {
+            const auto expected = catalogue_router.GetOptimalRoute(from, to);
+            const auto route = hilbert_router.GetOptimalRoute(from, to);
+            ASSERT_EQUAL(route.has_value(), expected.has_value());
+            if (route) {
+                ASSERT(std::abs(route->time - expected->time) < 1e-9);
+                ASSERT_EQUAL(route->route_edges.size(), expected->route_edges.size());
+            }
+        }
+    }
+}
+
+// проверка ленивого построения: без запросов к маршрутизатору он не строится, иначе строится и ответы идут по порядку
+void TestLazyTransportRouter() {
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    map_renderer::MapRendererSVG renderer;
+    TransportRouter router(catalogue);
+    request_handler::RequestHandler handler(catalogue, renderer, router);
+    handler.AddStopBaseRequest({"A"s, 55.611087, 37.20829, {}});
+    handler.AddStopBaseRequest({"B"s, 55.595884, 37.209755, {{"A"s, 2600}}});
+    handler.AddBusBaseRequest({"297"s, {"A"s, "B"s}, false});
+    handler.ApplyAllRequests();
+    RouterSettings settings;
+    settings.bus_velocity_ = 40;
+    settings.bus_wait_time_ = 6;
+    handler.AddRouterSettings(settings);
+
+    handler.AddStatResults({{1, "Bus"s, "297"s, {}, {}, {}, {}}, {2, "Stop"s, "A"s, {}, {}, {}, {}}});
+    ASSERT(!router.IsBuilt());
+
+    handler.AddStatResults({{3, "Route"s, {}, "A"s, "B"s, {}, {}}, {4, "Bus"s, "297"s, {}, {}, {}, {}},
+                            {5, "Route"s, {}, "B"s, "A"s, {}, {}}});
+    ASSERT(router.IsBuilt());
+    const auto& results = handler.GetStatResults();
+    ASSERT_EQUAL(results.size(), 5);
+    ASSERT_EQUAL(std::get<StatResultBus>(results[3]).first, 4);
+    ASSERT(std::get<StatResultBus>(results[3]).second.has_value());
+    ASSERT_EQUAL(std::get<StatResultRoute>(results[2]).first, 3);
+    ASSERT(std::abs(std::get<StatResultRoute>(results[2]).second->time - 9.9) < 1e-9);
+    ASSERT_EQUAL(std::get<StatResultRoute>(results[4]).first, 5);
+}
+
+// проверка сохранения маршрутизатора в файл и загрузки с проверкой контрольной суммы
+void TestRouterSerialization() {
+    using namespace transport_router;
+    TransportCatalogue catalogue;
+    catalogue.AddStop({"A", {55.611087, 37.20829}});
+    catalogue.AddStop({"B", {55.595884, 37.209755}});
+    catalogue.AddStop({"C", {55.632761, 37.333324}});
+    catalogue.AddBus({false, "14", {catalogue.FindStop("A"), catalogue.FindStop("B"), catalogue.FindStop("C")}});
+    catalogue.SetDistance("A"sv, "B"sv, 2000);
+    catalogue.SetDistance("B"sv, "C"sv, 3000);
+
+    RouterSettings settings;
+    settings.bus_velocity_ = 30;
+    settings.bus_wait_time_ = 4;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "transport_router_test.bin").string();
+    TransportRouter router(catalogue);
+    router.SetRouterSettings(settings);
+    router.SetVertexCount(catalogue.GetStops().size());
+    router.BuildTransportRouter();
+    router.SaveToFile(path);
+
+    // загруженный маршрутизатор отвечает так же, как построенный
+    TransportRouter loaded_router(catalogue);
+    loaded_router.SetRouterSettings(settings);
+    loaded_router.SetVertexCount(catalogue.GetStops().size());
+    ASSERT(loaded_router.LoadFromFile(path));
+    for (const auto& [from, to] : std::vector<std::pair<std::string, std::string>>{{"A", "C"}, {"C", "A"}, {"B", "A"}}) {
+        const auto expected = router.GetOptimalRoute(from, to);
+        const auto route = loaded_router.GetOptimalRoute(from, to);
+        ASSERT(route.has_value());
+        ASSERT_EQUAL(route->time, expected->time);
+        ASSERT_EQUAL(route->route_edges.size(), expected->route_edges.size());
+    }
+
+    // файл не подходит для других настроек маршрутизации
+    settings.bus_velocity_ = 40;
+    TransportRouter other_router(catalogue);
+    other_router.SetRouterSettings(settings);
+    other_router.SetVertexCount(catalogue.GetStops().size());
+    ASSERT(!other_router.LoadFromFile(path));
+
+    // метки-хабы сохраняются и загружаются вместе с графом
+    settings.router_type_ = RouterType::HUB_LABELS;
+    TransportRouter hub_router(catalogue);
+    hub_router.SetRouterSettings(settings);
+    hub_router.SetVertexCount(catalogue.GetStops().size());
+    hub_router.BuildTransportRouter();
+    hub_router.SaveToFile(path);
+    TransportRouter loaded_hub_router(catalogue);
+    loaded_hub_router.SetRouterSettings(settings);
+    loaded_hub_router.SetVertexCount(catalogue.GetStops().size());
+    ASSERT(loaded_hub_router.LoadFromFile(path));
+    for (const auto& [from, to] : std::vector<std::pair<std::string, std::string>>{{"A", "C"}, {"C", "A"}, {"B", "A"}}) {
+        const auto expected = hub_router.GetOptimalRoute(from, to);
+        const auto route = loaded_hub_router.GetOptimalRoute(from, to);
+        ASSERT(route.has_value());
+        ASSERT_EQUAL(route->time, expected->time);
+        ASSERT_EQUAL(route->route_edges.size(), expected->route_edges.size());
+    }
+
+    // обрезанный файл и файл с изменённым байтом меток (заголовок цел) не загружаются
+    std::string content;
+    {
+        std::ifstream input(path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    }
+    const auto write_file = [&path](const std::string& data) {
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        output.write(data.data(), static_cast<std::streamsize>(data.size()));
+    };
+    TransportRouter corrupted_router(catalogue);
+    corrupted_router.SetRouterSettings(settings);
+    corrupted_router.SetVertexCount(catalogue.GetStops().size());
+    write_file(content.substr(0, content.size() / 2));
+    ASSERT(!corrupted_router.LoadFromFile(path));
+    std::string flipped = content;
+    flipped[flipped.size() - 16] ^= 0x40;
+    write_file(flipped);
+    ASSERT(!corrupted_router.LoadFromFile(path));
+
+    // и таблица последних рёбер
+    settings.router_type_ = RouterType::ALL_PAIRS_COMPACT;
+    TransportRouter compact_router(catalogue);
+    compact_router.SetRouterSettings(settings);
+    compact_router.SetVertexCount(catalogue.GetStops().size());
+    compact_router.BuildTransportRouter();
+    compact_router.SaveToFile(path);
+    TransportRouter loaded_compact_router(catalogue);
+    loaded_compact_router.SetRouterSettings(settings);
+    loaded_compact_router.SetVertexCount(catalogue.GetStops().size());
+    ASSERT(loaded_compact_router.LoadFromFile(path));
+    for (const auto& [from, to] : std::vector<std::pair<std::string, std::string>>{{"A", "C"}, {"C", "A"}, {"B", "A"}}) {
+        const auto expected = compact_router.GetOptimalRoute(from, to);
+        const auto route = loaded_compact_router.GetOptimalRoute(from, to);
+        ASSERT(route.has_value());
+        ASSERT_EQUAL(route->time, expected->time);
+        ASSERT_EQUAL(route->route_edges.size(), expected->route_edges.size());
+    }
+
+    std::remove(path.c_str());
+}
+
 void RunTests() {
     //geo
     RUN_TEST(TestComputeDistance);
@@ -427,12 +1711,37 @@ void RunTests() {
 
     //graph & router
     RUN_TEST(TestGraphAndRouter);
+    RUN_TEST(TestCompactGraph);
+    RUN_TEST(TestPruneDominatedEdges);
+    RUN_TEST(TestParallelRouter);
+    RUN_TEST(TestNarrowWeightRouter);
+    RUN_TEST(TestWorkerPool);
+    RUN_TEST(TestPredecessorRouter);
+    RUN_TEST(TestDijkstraRouter);
+    RUN_TEST(TestBuildRoutes);
+    RUN_TEST(TestBuildWeights);
+    RUN_TEST(TestAStarRouter);
+    RUN_TEST(TestContractionHierarchyRouter);
+    RUN_TEST(TestHubLabelRouter);
 
     // mr
     RUN_TEST(TestSphereProjector);
 
     // ro
     RUN_TEST(GetOptimalRoute);
+    RUN_TEST(TestRoutePatternGraph);
+    RUN_TEST(TestHilbertVertexOrder);
+    RUN_TEST(TestParetoRoutes);
+    RUN_TEST(TestAlternativeRoutes);
+    RUN_TEST(TestTimetableRoute);
+    RUN_TEST(TestUpdateRouterSettings);
+    RUN_TEST(TestIncrementalRouterUpdates);
+    RUN_TEST(TestRaptorRouter);
+    RUN_TEST(TestTravelTimes);
+    RUN_TEST(TestReachableStops);
+    RUN_TEST(TestRouteCache);
+    RUN_TEST(TestLazyTransportRouter);
+    RUN_TEST(TestRouterSerialization);
 
     std::cerr << std::endl << "All tests passed successfully!"s << std::endl << std::endl;
 }
@@ -5,13 +5,15 @@ namespace transport_catalogue {
     using namespace domain;
 
 void TransportCatalogue::AddStop(const Stop& stop) {
-    const Stop* temp = &stops_.emplace_back(stop);
+    Stop* temp = &stops_.emplace_back(stop);
+    temp->id = static_cast<StopId>(stops_.size() - 1);
     stopname_to_stop_[temp->name] = temp;
     //std::cerr << "new Stop #"<< stops_.size() <<" added in deque" << std::endl;
 }
     
 void TransportCatalogue::AddBus(const Bus& bus) {
-    const auto* temp = &buses_.emplace_back(bus);
+    auto* temp = &buses_.emplace_back(bus);
+    temp->id = static_cast<BusId>(buses_.size() - 1);
     busname_to_bus_[temp->name] = temp;
 
     for (size_t i = 0; i < temp->route.size(); ++i) {
@@ -20,6 +22,25 @@ void TransportCatalogue::AddBus(const Bus& bus) {
     //std::cerr << "new Bus #" << buses_.size() <<" added in deque" << std::endl;
 }
 
+void TransportCatalogue::RemoveBus(const std::string_view name) {
+    const auto it = busname_to_bus_.find(name);
+    if (it == busname_to_bus_.end()) {
+        return;
+    }
+    Bus& bus = buses_[it->second->id];
+    busname_to_bus_.erase(it);
+
+    // остановка без автобусов не попадает в stopname_to_buses_, как и при добавлении
+    for (const Stop* stop : bus.route) {
+        const auto buses_it = stopname_to_buses_.find(stop);
+        if (buses_it != stopname_to_buses_.end() && buses_it->second.erase(&bus) != 0 && buses_it->second.empty()) {
+            stopname_to_buses_.erase(buses_it);
+        }
+    }
+    bus.route.clear();
+    bus.departures.clear();
+}
+
 const Stop* TransportCatalogue::FindStop(const std::string_view name) const {
     return stopname_to_stop_.count(name) ? stopname_to_stop_.at(name) : nullptr;
 }
@@ -98,6 +119,14 @@ const std::deque<Stop>& TransportCatalogue::GetStops() const {
     return stops_;
 }
 
+std::string_view TransportCatalogue::GetStopName(StopId id) const {
+    return stops_.at(id).name;
+}
+
+std::string_view TransportCatalogue::GetBusName(BusId id) const {
+    return buses_.at(id).name;
+}
+
 size_t TransportCatalogue::ComputeCountUniqueStops(const std::vector<const Stop*>& route) const {
     std::unordered_set<const Stop*> unique_stops{ route.begin(), route.end() };
     return unique_stops.size();
@@ -29,6 +29,10 @@ public:
     
     // Добавление маршрута в базу данных
     void AddBus(const domain::Bus& bus);
+
+    // Удаление маршрута: автобус больше не находится по названию и не проходит через остановки.
+    // Его место в GetBuses() остаётся с пустым маршрутом, чтобы номера остальных автобусов не менялись
+    void RemoveBus(const std::string_view name);
     
     // Остановка по названию остановки
     const domain::Stop* FindStop(const std::string_view name) const;
@@ -57,6 +61,10 @@ public:
     // Возвращает остановки (только на маршрутах) 
     const std::deque<domain::Stop>& GetStops() const;
 
+    // Название остановки и автобуса по номеру: описания рёбер и маршрутов хранят номера, а не копии названий
+    std::string_view GetStopName(domain::StopId id) const;
+    std::string_view GetBusName(domain::BusId id) const;
+
 private:
 
     std::deque<domain::Stop> stops_; //все остановки
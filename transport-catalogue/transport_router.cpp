@@ -6,6 +6,8 @@ namespace transport_router {
     
     void TransportRouter::SetRouterSettings(const RouterSettings& settings) {
         settings_ = settings;
+        route_cache_.SetCapacity(settings.route_cache_capacity_);
+        route_cache_.Clear();
     }
 
     void TransportRouter::SetVertexCount(const size_t count) {
@@ -13,6 +15,19 @@ namespace transport_router {
     }
 
     void TransportRouter::BuildTransportRouter() {
+        // маршруты прежнего маршрутизатора недействительны
+        route_cache_.Clear();
+        alternative_search_.reset();
+        router_.reset();
+        raptor_router_.reset();
+        BuildTimetableRouter();
+
+        // RAPTOR работает по маршрутам справочника
+        if (settings_.router_type_ == RouterType::RAPTOR) {
+            BuildRouter();
+            return;
+        }
+
         // создаём граф
         BuildGraph();
 
@@ -21,105 +36,1077 @@ namespace transport_router {
         //std::cerr << "Wait-edges count: " << id_to_edge_infos_.size() << std::endl;
 
         // добавляем рёбра маршрута
-        for (const auto& [ is_roundtrip, bus_name, route ] : db_.GetBuses()) {
-            AddAllBusEdgeInfos(bus_name, route);
-            if (!is_roundtrip) { // // для прямого маршрута A,B,C,B,A путь туда-обратно A,B,C + C,B,A
-                std::vector<Stop const*> reversed_route(route.rbegin(), route.rend());
-                AddAllBusEdgeInfos(bus_name, std::move(reversed_route));
-            }
+        for (const auto& bus : db_.GetBuses()) {
+            AddBusEdges(bus);
         }
         //std::cerr << "Total edges count: " << id_to_edge_infos_.size() << std::endl;
 
+        // из параллельных рёбер (несколько автобусов на одном перегоне) на оптимальном пути бывает только самое быстрое
+        PruneDominatedEdges();
+
+        // сжимаем граф, изменяемый граф больше не нужен
+        compact_graph_ = CompactGraph(graph_);
+        graph_ = Graph();
+        ++build_stats_.graph_builds;
+
         // создаём маршрутизатор
         BuildRouter();
     }
 
-    std::optional<RouteInfo> TransportRouter::GetOptimalRoute(const std::string& from_stop, const std::string& to_stop) const {    
-        std::vector<EdgeInfo> optimal_route;
-        double total_time = 0.0;
+    void TransportRouter::UpdateRouterSettings(const RouterSettings& settings) {
+        const RouterSettings old_settings = settings_;
+        SetRouterSettings(settings);
+
+        // граф тот же, если тип маршрутизатора, модель графа и нумерация вершин не изменились
+        const bool is_same_graph = router_ != nullptr && settings.router_type_ == old_settings.router_type_
+            && settings.graph_model_ == old_settings.graph_model_ && settings.vertex_order_ == old_settings.vertex_order_;
+        const double scale = old_settings.bus_velocity_ / settings.bus_velocity_;
+        if (!is_same_graph || (!std::is_floating_point_v<RouteWeight> && scale != 1.0)) {
+            BuildTransportRouter();
+            return;
+        }
+        if (scale == 1.0 && settings.bus_wait_time_ == old_settings.bus_wait_time_) {
+            return;
+        }
+
+        // входящие дуги поиска альтернатив хранят копии весов, расписания зависят от скорости
+        alternative_search_.reset();
+        if (scale != 1.0) {
+            BuildTimetableRouter();
+        }
+        ReweightEdges(scale);
+
+        const bool is_scaled = std::abs(settings.bus_wait_time_ - old_settings.bus_wait_time_ * scale)
+                               <= 1e-12 * settings.bus_wait_time_;
+        if (!is_scaled || !router_->ScaleWeights(scale)) {
+            BuildRouter();
+        }
+    }
+
+    void TransportRouter::AddStop(const Stop& stop) {
+        if (!IsBuilt() || stop_to_id_vertices_.count(&stop) != 0) {
+            return;
+        }
+        if (raptor_router_) {
+            UpdateRaptorRouter();
+            return;
+        }
+        vertex_count_ += 2;
+        graph_ = Graph(vertex_to_stop_.size() + 2);
+        AddStopVertices(&stop);
+        ApplyGraphChanges(std::vector<bool>(compact_graph_.GetEdgeCount(), false));
+    }
+
+    void TransportRouter::AddBus(const Bus& bus) {
+        if (!IsBuilt()) {
+            return;
+        }
+
+        // новые остановки маршрута получают вершины вместе с автобусом
+        std::vector<const Stop*> new_stops;
+        for (const Stop* stop : bus.route) {
+            if (stop_to_id_vertices_.count(stop) == 0
+                && std::find(new_stops.begin(), new_stops.end(), stop) == new_stops.end()) {
+                new_stops.push_back(stop);
+            }
+        }
+        if (raptor_router_) {
+            UpdateRaptorRouter();
+            return;
+        }
+        vertex_count_ += 2 * new_stops.size();
+        const size_t riding_vertex_count = settings_.graph_model_ != GraphModel::ROUTE_PATTERNS ? 0
+            : bus.is_roundtrip ? bus.route.size() : 2 * bus.route.size();
+        graph_ = Graph(vertex_to_stop_.size() + 2 * new_stops.size() + riding_vertex_count);
+        for (const Stop* stop : new_stops) {
+            AddStopVertices(stop);
+        }
+        AddBusEdges(bus);
+        ApplyGraphChanges(std::vector<bool>(compact_graph_.GetEdgeCount(), false));
+    }
+
+    void TransportRouter::RemoveBus(const Bus& bus) {
+        if (!IsBuilt()) {
+            return;
+        }
+        if (raptor_router_) {
+            UpdateRaptorRouter();
+            return;
+        }
+
+        // рёбра автобуса (в модели ROUTE_PATTERNS его вершины движения остаются без рёбер)
+        std::vector<bool> is_removed_edge(compact_graph_.GetEdgeCount(), false);
+        std::set<std::pair<graph::VertexId, graph::VertexId>> removed_pairs;
+        for (graph::EdgeId edge_id = 0; edge_id < id_to_edge_infos_.size(); ++edge_id) {
+            const auto* bus_edge_info = std::get_if<BusEdgeInfo>(&id_to_edge_infos_[edge_id]);
+            if (bus_edge_info != nullptr && bus_edge_info->bus == bus.id) {
+                is_removed_edge[edge_id] = true;
+                const auto edge = compact_graph_.GetEdge(edge_id);
+                removed_pairs.insert({ edge.from, edge.to });
+            }
+        }
+
+        // в модели STOP_PAIRS рёбра автобуса могли вытеснить параллельные рёбра других автобусов с тех же остановок:
+        // из них возвращается самое быстрое, как при построении
+        graph_ = Graph(vertex_to_stop_.size());
+        if (settings_.graph_model_ == GraphModel::STOP_PAIRS) {
+            std::set<const Bus*> buses;
+            for (const auto& [from, to] : removed_pairs) {
+                if (const auto* stop_buses = db_.GetBusesByStop(vertex_to_stop_[from]->name)) {
+                    buses.insert(stop_buses->begin(), stop_buses->end());
+                }
+            }
+            std::vector<const Bus*> ordered_buses(buses.begin(), buses.end());
+            std::sort(ordered_buses.begin(), ordered_buses.end(), [](const Bus* lhs, const Bus* rhs) {
+                return lhs->id < rhs->id;
+            });
+            for (const Bus* other_bus : ordered_buses) {
+                AddBusEdges(*other_bus);
+            }
+            std::vector<bool> is_kept(graph_.GetEdgeCount());
+            for (graph::EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                is_kept[edge_id] = removed_pairs.count({ edge.from, edge.to }) != 0;
+            }
+            FilterAddedEdges(is_kept);
+        }
+        ApplyGraphChanges(std::move(is_removed_edge));
+    }
+
+    std::optional<RouteInfo> TransportRouter::GetOptimalRoute(const std::string& from_stop, const std::string& to_stop) const {
+        graph::SearchStats stats;
+        return GetOptimalRoute(from_stop, to_stop, stats);
+    }
+
+    std::optional<RouteInfo> TransportRouter::GetOptimalRoute(const std::string& from_stop, const std::string& to_stop,
+                                                              graph::SearchStats& stats) const {
+        stats = {};
+        const Stop* from = db_.FindStop(from_stop);
+        const Stop* to = db_.FindStop(to_stop);
 
         // нет указанных остановок
-        if (stop_to_id_vertices_.count(db_.FindStop(from_stop)) == 0 || stop_to_id_vertices_.count(db_.FindStop(to_stop)) == 0) {
+        if (from == nullptr || to == nullptr) {
+            return std::nullopt;
+        }
+
+        const uint64_t key = GetRouteCacheKey(from, to);
+        if (auto cached_route = route_cache_.Get(key)) {
+            return std::move(*cached_route);
+        }
+        auto route = FindOptimalRoute(from, to, stats);
+        route_cache_.Put(key, route);
+        return route;
+    }
+
+    std::vector<std::optional<RouteInfo>> TransportRouter::GetOptimalRoutes(const std::string& from_stop,
+                                                                            const std::vector<std::string>& to_stops) const {
+        std::vector<std::optional<RouteInfo>> optimal_routes(to_stops.size());
+        const Stop* from = db_.FindStop(from_stop);
+        if (from == nullptr) {
+            return optimal_routes;
+        }
+
+        // ищем только существующие остановки назначения, которых нет в кэше, запоминая их позиции в ответе
+        std::vector<size_t> positions;
+        std::vector<const Stop*> to;
+        for (size_t i = 0; i < to_stops.size(); ++i) {
+            const Stop* stop = db_.FindStop(to_stops[i]);
+            if (stop == nullptr) {
+                continue;
+            }
+            if (auto cached_route = route_cache_.Get(GetRouteCacheKey(from, stop))) {
+                optimal_routes[i] = std::move(*cached_route);
+                continue;
+            }
+            positions.push_back(i);
+            to.push_back(stop);
+        }
+        if (to.empty()) {
+            return optimal_routes;
+        }
+
+        auto routes = FindOptimalRoutes(from, to);
+        for (size_t i = 0; i < routes.size(); ++i) {
+            route_cache_.Put(GetRouteCacheKey(from, to[i]), routes[i]);
+            optimal_routes[positions[i]] = std::move(routes[i]);
+        }
+        return optimal_routes;
+    }
+
+    std::optional<std::vector<RouteInfo>> TransportRouter::GetParetoRoutes(const std::string& from_stop,
+                                                                           const std::string& to_stop) const {
+        const Stop* from = db_.FindStop(from_stop);
+        const Stop* to = db_.FindStop(to_stop);
+        if (from == nullptr || to == nullptr) {
+            return std::nullopt;
+        }
+        if (raptor_router_) {
+            return raptor_router_->FindParetoRoutes(from, to);
+        }
+
+        std::vector<RouteInfo> routes;
+        if (stop_to_id_vertices_.count(from) == 0 || stop_to_id_vertices_.count(to) == 0) {
+            return routes;
+        }
+        // второй критерий - рёбра ожидания: каждая поездка начинается с ожидания автобуса
+        const auto is_wait_edge = [this](graph::EdgeId edge_id) {
+            return std::holds_alternative<WaitEdgeInfo>(id_to_edge_infos_[edge_id]);
+        };
+        const size_t max_trips = settings_.max_transfers_ ? *settings_.max_transfers_ + 1 : graph::UNLIMITED_COUNT;
+        graph::SearchStats stats;
+        for (auto& route : graph::SearchParetoRoutes(compact_graph_, stop_to_id_vertices_.at(from).first,
+                                                     stop_to_id_vertices_.at(to).first, is_wait_edge, max_trips, stats)) {
+            routes.push_back(MakeRouteInfo(RouterBase::RouteInfo{ route.weight, std::move(route.edges) }));
+        }
+        return routes;
+    }
+
+    std::optional<std::vector<RouteInfo>> TransportRouter::GetAlternativeRoutes(const std::string& from_stop,
+                                                                                const std::string& to_stop,
+                                                                                size_t count) const {
+        const Stop* from = db_.FindStop(from_stop);
+        const Stop* to = db_.FindStop(to_stop);
+        if (from == nullptr || to == nullptr) {
+            return std::nullopt;
+        }
+        std::vector<RouteInfo> routes;
+        graph::SearchStats stats;
+        if (raptor_router_) {
+            if (auto route = raptor_router_->FindRoute(from, to, stats); route && count > 0) {
+                routes.push_back(std::move(*route));
+            }
+            return routes;
+        }
+        if (stop_to_id_vertices_.count(from) == 0 || stop_to_id_vertices_.count(to) == 0) {
+            return routes;
+        }
+
+        // пересесть на тот же автобус не на конечной - та же поездка с лишним ожиданием
+        const auto is_useful = [this](const std::vector<graph::EdgeId>& edges) {
+            const auto route_edges = MakeRouteInfo(RouterBase::RouteInfo{ RouteWeight{}, edges }).route_edges;
+            for (size_t i = 2; i < route_edges.size(); i += 2) {
+                const auto* trip = std::get_if<BusEdgeInfo>(&route_edges[i - 1]);
+                const auto* next_trip = std::get_if<BusEdgeInfo>(&route_edges[i + 1]);
+                const auto* wait = std::get_if<WaitEdgeInfo>(&route_edges[i]);
+                if (trip == nullptr || next_trip == nullptr || wait == nullptr || trip->bus != next_trip->bus) {
+                    continue;
+                }
+                const auto& bus_route = db_.GetBuses()[trip->bus].route;
+                if (wait->stop != bus_route.front()->id && wait->stop != bus_route.back()->id) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        if (!alternative_search_) {
+            alternative_search_ = std::make_unique<AlternativeRouteSearch>(compact_graph_);
+        }
+        for (const auto& route : alternative_search_->FindRoutes(stop_to_id_vertices_.at(from).first,
+                                                                 stop_to_id_vertices_.at(to).first, count,
+                                                                 graph::AlternativeRouteSettings{}, is_useful, stats)) {
+            routes.push_back(MakeRouteInfo(route));
+        }
+        return routes;
+    }
+
+    std::optional<RouteInfo> TransportRouter::GetTimetableRoute(const std::string& from_stop, const std::string& to_stop,
+                                                                double departure_time) const {
+        graph::SearchStats stats;
+        return GetTimetableRoute(from_stop, to_stop, departure_time, stats);
+    }
+
+    std::optional<RouteInfo> TransportRouter::GetTimetableRoute(const std::string& from_stop, const std::string& to_stop,
+                                                                double departure_time, graph::SearchStats& stats) const {
+        stats = {};
+        const Stop* from = db_.FindStop(from_stop);
+        const Stop* to = db_.FindStop(to_stop);
+        if (from == nullptr || to == nullptr || !timetable_router_) {
+            return std::nullopt;
+        }
+        return timetable_router_->FindRoute(from, to, departure_time, stats);
+    }
+
+    size_t TransportRouter::GetPrunedEdgeCount() const {
+        return pruned_edge_count_;
+    }
+
+    bool TransportRouter::IsBuilt() const {
+        return router_ != nullptr || raptor_router_ != nullptr;
+    }
+
+    lru_cache::CacheStats TransportRouter::GetRouteCacheStats() const {
+        return route_cache_.GetStats();
+    }
+
+    BuildStats TransportRouter::GetBuildStats() const {
+        return build_stats_;
+    }
+
+    uint64_t TransportRouter::GetRouteCacheKey(const Stop* from, const Stop* to) {
+        return (static_cast<uint64_t>(from->id) << 32) | to->id;
+    }
+
+    std::optional<RouteInfo> TransportRouter::FindOptimalRoute(const Stop* from, const Stop* to,
+                                                               graph::SearchStats& stats) const {
+        if (raptor_router_) {
+            return raptor_router_->FindRoute(from, to, stats);
+        }
+        if (stop_to_id_vertices_.count(from) == 0 || stop_to_id_vertices_.count(to) == 0) {
             return std::nullopt;
         }
 
-        auto from = GetStopPairID(from_stop).first; //уезжаем с ожиданием
-        auto to = GetStopPairID(to_stop).first; // приезжаем без ожидания
-        const auto route = router_.get()->BuildRoute(from, to);
+        const auto route = router_.get()->BuildRouteWithStats(stop_to_id_vertices_.at(from).first, //уезжаем с ожиданием
+                                                              stop_to_id_vertices_.at(to).first, // приезжаем без ожидания
+                                                              stats);
 
         // не найден маршрут
         if (!route.has_value()) {
             return std::nullopt;
         }
+        return MakeRouteInfo(route.value());
+    }
+
+    std::vector<std::optional<RouteInfo>> TransportRouter::FindOptimalRoutes(const Stop* from,
+                                                                             const std::vector<const Stop*>& to) const {
+        if (raptor_router_) {
+            return raptor_router_->FindRoutes(from, to);
+        }
+
+        std::vector<std::optional<RouteInfo>> optimal_routes(to.size());
+        if (stop_to_id_vertices_.count(from) == 0) {
+            return optimal_routes;
+        }
+
+        std::vector<size_t> positions;
+        std::vector<graph::VertexId> to_vertices;
+        for (size_t i = 0; i < to.size(); ++i) {
+            if (stop_to_id_vertices_.count(to[i]) != 0) {
+                positions.push_back(i);
+                to_vertices.push_back(stop_to_id_vertices_.at(to[i]).first);
+            }
+        }
+
+        const auto routes = router_.get()->BuildRoutes(stop_to_id_vertices_.at(from).first, to_vertices);
+        for (size_t i = 0; i < routes.size(); ++i) {
+            if (routes[i].has_value()) {
+                optimal_routes[positions[i]] = MakeRouteInfo(routes[i].value());
+            }
+        }
+        return optimal_routes;
+    }
+
+    TravelTimes TransportRouter::GetTravelTimes(const std::vector<std::string>& from_stops,
+                                                const std::vector<std::string>& to_stops) const {
+        if (raptor_router_) {
+            std::vector<const Stop*> from;
+            for (const auto& stop_name : from_stops) {
+                from.push_back(db_.FindStop(stop_name));
+            }
+            std::vector<const Stop*> to;
+            for (const auto& stop_name : to_stops) {
+                to.push_back(db_.FindStop(stop_name));
+            }
+            return raptor_router_->FindTravelTimes(from, to);
+        }
 
-        // добавляем все рёбра маршрута
-        for (const auto& id : route.value().edges) {
-            optimal_route.push_back(id_to_edge_infos_[id]);
-            if (std::holds_alternative<WaitEdgeInfo>(id_to_edge_infos_[id])) { 
-                const auto& wait_edge_info = std::get<WaitEdgeInfo>(id_to_edge_infos_[id]);
-                total_time += wait_edge_info.time;
-            } else if (std::holds_alternative<BusEdgeInfo>(id_to_edge_infos_[id])) { 
-                const auto& bus_edge_info = std::get<BusEdgeInfo>(id_to_edge_infos_[id]);
-                total_time += bus_edge_info.time;
+        TravelTimes times(from_stops.size(), std::vector<std::optional<double>>(to_stops.size()));
+
+        // в матрицу маршрутизатора попадают только существующие остановки, запоминаем их позиции в ответе
+        const auto collect_vertices = [this](const std::vector<std::string>& stops,
+                                             std::vector<size_t>& positions, std::vector<graph::VertexId>& vertices) {
+            for (size_t i = 0; i < stops.size(); ++i) {
+                if (stop_to_id_vertices_.count(db_.FindStop(stops[i])) != 0) {
+                    positions.push_back(i);
+                    vertices.push_back(GetStopPairID(stops[i]).first);
+                }
+            }
+        };
+        std::vector<size_t> from_positions;
+        std::vector<graph::VertexId> from_vertices;
+        collect_vertices(from_stops, from_positions, from_vertices);
+        std::vector<size_t> to_positions;
+        std::vector<graph::VertexId> to_vertices;
+        collect_vertices(to_stops, to_positions, to_vertices);
+        if (from_vertices.empty() || to_vertices.empty()) {
+            return times;
+        }
+
+        const auto weights = router_.get()->BuildWeights(from_vertices, to_vertices);
+        for (size_t i = 0; i < from_vertices.size(); ++i) {
+            for (size_t j = 0; j < to_vertices.size(); ++j) {
+                if (const auto& weight = weights[i * to_vertices.size() + j]) {
+                    times[from_positions[i]][to_positions[j]] = ToRouteTime(*weight);
+                }
+            }
+        }
+        return times;
+    }
+
+    std::optional<std::vector<ReachableStop>> TransportRouter::GetReachableStops(const std::string& from_stop,
+                                                                                 double time_budget) const {
+        const Stop* stop = db_.FindStop(from_stop);
+        if (raptor_router_ ? stop == nullptr : stop_to_id_vertices_.count(stop) == 0) {
+            return std::nullopt;
+        }
+        // отрицательного (или не числового) бюджета не хватает даже на исходную остановку
+        if (!(time_budget >= 0.0)) {
+            return std::vector<ReachableStop>{};
+        }
+        if (raptor_router_) {
+            return raptor_router_->FindReachableStops(stop, time_budget);
+        }
+
+        // остановка достигнута, когда просмотрена её вершина ожидания (первая из пары)
+        std::vector<ReachableStop> reachable_stops;
+        for (const auto& [vertex, weight] : graph::SearchWithinBudget(compact_graph_, GetStopPairID(from_stop).first,
+                                                                      ToRouteWeight(time_budget))) {
+            if (stop_to_id_vertices_.at(vertex_to_stop_[vertex]).first == vertex) {
+                reachable_stops.push_back({ vertex_to_stop_[vertex]->name, ToRouteTime(weight) });
+            }
+        }
+        return reachable_stops;
+    }
+
+    RouteInfo TransportRouter::MakeRouteInfo(const RouterBase::RouteInfo& route) const {
+        std::vector<EdgeInfo> optimal_route;
+
+        // добавляем все рёбра маршрута; подряд идущие рёбра движения (посадка, перегоны, высадка
+        // в модели ROUTE_PATTERNS) - одна поездка на автобусе, между поездками всегда есть ожидание
+        for (const auto& id : route.edges) {
+            const auto& edge_info = id_to_edge_infos_[id];
+            if (std::holds_alternative<BusEdgeInfo>(edge_info) && !optimal_route.empty()
+                && std::holds_alternative<BusEdgeInfo>(optimal_route.back())) {
+                const auto& bus_edge_info = std::get<BusEdgeInfo>(edge_info);
+                auto& trip = std::get<BusEdgeInfo>(optimal_route.back());
+                trip.time += bus_edge_info.time;
+                trip.span_count += bus_edge_info.span_count;
+            } else {
+                optimal_route.push_back(edge_info);
+            }
+        }
+
+        double total_time = 0.0;
+        for (const auto& edge_info : optimal_route) {
+            if (std::holds_alternative<WaitEdgeInfo>(edge_info)) { 
+                total_time += std::get<WaitEdgeInfo>(edge_info).time;
+            } else if (std::holds_alternative<BusEdgeInfo>(edge_info)) { 
+                total_time += std::get<BusEdgeInfo>(edge_info).time;
             }
         }
         return RouteInfo{total_time, optimal_route};
     }
 
+    void TransportRouter::SaveToFile(const std::string& path) const {
+        // запись во временный файл и переименование: процессы, уже отобразившие файл, его не увидят частично
+        const std::string temp_path = path + ".tmp";
+        {
+            std::ofstream output(temp_path, std::ios::binary | std::ios::trunc);
+            serialization::BinaryWriter writer(output);
+            writer.WriteBytes(FILE_MAGIC, sizeof(FILE_MAGIC));
+            writer.Write(FILE_VERSION);
+            writer.Write(static_cast<uint32_t>(settings_.router_type_));
+            writer.Write(ComputeChecksum());
+            writer.Write(static_cast<uint64_t>(compact_graph_.GetVertexCount()));
+            writer.Write(static_cast<uint64_t>(compact_graph_.GetEdgeCount()));
+            writer.Write(static_cast<uint64_t>(pruned_edge_count_));
+
+            // рёбра графа и их описания
+            for (graph::EdgeId edge_id = 0; edge_id < compact_graph_.GetEdgeCount(); ++edge_id) {
+                const auto edge = compact_graph_.GetEdge(edge_id);
+                writer.Write(static_cast<uint64_t>(edge.from));
+                writer.Write(static_cast<uint64_t>(edge.to));
+                writer.Write(edge.weight);
+            }
+            for (const auto& edge_info : id_to_edge_infos_) {
+                if (std::holds_alternative<BusEdgeInfo>(edge_info)) {
+                    const auto& bus_edge_info = std::get<BusEdgeInfo>(edge_info);
+                    writer.Write(static_cast<uint8_t>(0));
+                    writer.Write(bus_edge_info.bus);
+                    writer.Write(bus_edge_info.time);
+                    writer.Write(bus_edge_info.span_count);
+                } else {
+                    const auto& wait_edge_info = std::get<WaitEdgeInfo>(edge_info);
+                    writer.Write(static_cast<uint8_t>(1));
+                    writer.Write(wait_edge_info.stop);
+                    writer.Write(wait_edge_info.time);
+                }
+            }
+
+            // вершины остановок: номер остановки в справочнике и пара вершин
+            writer.Write(static_cast<uint64_t>(stop_to_id_vertices_.size()));
+            const auto& stops = db_.GetStops();
+            std::unordered_map<const Stop*, uint64_t> stop_indexes;
+            for (size_t stop_index = 0; stop_index < stops.size(); ++stop_index) {
+                stop_indexes[&stops[stop_index]] = stop_index;
+                const auto it = stop_to_id_vertices_.find(&stops[stop_index]);
+                if (it != stop_to_id_vertices_.end()) {
+                    writer.Write(static_cast<uint64_t>(stop_index));
+                    writer.Write(static_cast<uint64_t>(it->second.first));
+                    writer.Write(static_cast<uint64_t>(it->second.second));
+                }
+            }
+
+            // остановка каждой вершины (включая вершины движения модели ROUTE_PATTERNS)
+            for (const Stop* stop : vertex_to_stop_) {
+                writer.Write(stop_indexes.at(stop));
+            }
+
+            // таблица маршрутов всех пар или метки, выровненные для отображения в память
+            if (const auto* router = dynamic_cast<const Router*>(router_.get())) {
+                writer.Write(TableKind::ALL_PAIRS);
+                writer.Align(TABLE_ALIGNMENT);
+                // в файле строки без запаса под новые вершины
+                const size_t count = router->GetVertexCount();
+                for (size_t from = 0; from < count; ++from) {
+                    writer.WriteBytes(router->GetWeights() + from * router->GetRowSize(), count * sizeof(RouteWeight));
+                }
+                for (size_t from = 0; from < count; ++from) {
+                    writer.WriteBytes(router->GetPrevEdges() + from * router->GetRowSize(),
+                                      count * sizeof(graph::EdgeId));
+                }
+            } else if (const auto* hub_router = dynamic_cast<const HubLabelRouter*>(router_.get())) {
+                const size_t count = hub_router->GetVertexCount();
+                writer.Write(TableKind::HUB_LABELS);
+                writer.Align(TABLE_ALIGNMENT);
+                writer.WriteBytes(hub_router->GetHubVertices(), count * sizeof(uint32_t));
+                writer.WriteBytes(hub_router->GetOutOffsets(), (count + 1) * sizeof(uint32_t));
+                writer.WriteBytes(hub_router->GetInOffsets(), (count + 1) * sizeof(uint32_t));
+                writer.Align(TABLE_ALIGNMENT);
+                writer.WriteBytes(hub_router->GetOutLabels(),
+                                  hub_router->GetOutOffsets()[count] * sizeof(HubLabelRouter::LabelEntry));
+                writer.WriteBytes(hub_router->GetInLabels(),
+                                  hub_router->GetInOffsets()[count] * sizeof(HubLabelRouter::LabelEntry));
+            } else if (const auto* predecessor_router = dynamic_cast<const PredecessorRouter16*>(router_.get())) {
+                writer.Write(TableKind::PREDECESSORS);
+                writer.Write(static_cast<uint8_t>(sizeof(uint16_t)));
+                writer.Align(TABLE_ALIGNMENT);
+                writer.WriteBytes(predecessor_router->GetPrevEdges(),
+                                  predecessor_router->GetTableSize() * sizeof(uint16_t));
+            } else if (const auto* predecessor_router = dynamic_cast<const PredecessorRouter32*>(router_.get())) {
+                writer.Write(TableKind::PREDECESSORS);
+                writer.Write(static_cast<uint8_t>(sizeof(uint32_t)));
+                writer.Align(TABLE_ALIGNMENT);
+                writer.WriteBytes(predecessor_router->GetPrevEdges(),
+                                  predecessor_router->GetTableSize() * sizeof(uint32_t));
+            } else {
+                writer.Write(TableKind::NONE);
+            }
+            writer.WriteChecksum();
+            if (!output) {
+                throw std::runtime_error("Failed to write router file " + temp_path);
+            }
+        }
+        if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+            std::remove(temp_path.c_str());
+            throw std::runtime_error("Failed to replace router file " + path);
+        }
+    }
+
+    bool TransportRouter::LoadFromFile(const std::string& path) {
+        route_cache_.Clear();
+        alternative_search_.reset();
+        BuildTimetableRouter(); // расписания в файл не сохраняются, связи строятся быстро
+        serialization::MappedFile file(path);
+        if (!file.IsOpen()) {
+            return false;
+        }
+        try {
+            serialization::BinaryReader reader(file.GetData(), file.GetSize());
+            if (std::memcmp(reader.Skip(sizeof(FILE_MAGIC)), FILE_MAGIC, sizeof(FILE_MAGIC)) != 0
+                || reader.Read<uint32_t>() != FILE_VERSION
+                || reader.Read<uint32_t>() != static_cast<uint32_t>(settings_.router_type_)
+                || reader.Read<uint64_t>() != ComputeChecksum()) {
+                return false;
+            }
+            // таблицы и метки используются без проверки номеров, поэтому до разбора проверяется весь файл
+            if (!serialization::HasValidChecksum(file.GetData(), file.GetSize())) {
+                return false;
+            }
+            const auto vertex_count = reader.Read<uint64_t>();
+            const auto edge_count = reader.Read<uint64_t>();
+            const auto pruned_edge_count = reader.Read<uint64_t>();
+
+            Graph graph(vertex_count);
+            for (uint64_t i = 0; i < edge_count; ++i) {
+                const auto from = reader.Read<uint64_t>();
+                const auto to = reader.Read<uint64_t>();
+                if (from >= vertex_count || to >= vertex_count) {
+                    return false;
+                }
+                graph.AddEdge(Edge{ from, to, reader.Read<RouteWeight>() });
+            }
+            std::vector<EdgeInfo> id_to_edge_infos;
+            id_to_edge_infos.reserve(edge_count);
+            for (uint64_t i = 0; i < edge_count; ++i) {
+                // номера из файла того же справочника: контрольная сумма подтверждает порядок остановок и автобусов
+                const auto kind = reader.Read<uint8_t>();
+                const auto id = reader.Read<uint32_t>();
+                const auto time = reader.Read<double>();
+                if (kind == 0 && id < db_.GetBuses().size()) {
+                    id_to_edge_infos.emplace_back(BusEdgeInfo{ id, time, reader.Read<uint32_t>() });
+                } else if (kind == 1 && id < db_.GetStops().size()) {
+                    id_to_edge_infos.emplace_back(WaitEdgeInfo{ id, time });
+                } else {
+                    return false;
+                }
+            }
+
+            const auto& stops = db_.GetStops();
+            std::unordered_map<const Stop*, std::pair<size_t, size_t>> stop_to_id_vertices;
+            std::vector<const Stop*> vertex_to_stop(vertex_count, nullptr);
+            const auto stop_count = reader.Read<uint64_t>();
+            for (uint64_t i = 0; i < stop_count; ++i) {
+                const Stop* stop = &stops.at(reader.Read<uint64_t>());
+                const auto first = reader.Read<uint64_t>();
+                const auto second = reader.Read<uint64_t>();
+                if (first >= vertex_count || second >= vertex_count) {
+                    return false;
+                }
+                stop_to_id_vertices[stop] = { first, second };
+            }
+            for (auto& stop : vertex_to_stop) {
+                stop = &stops.at(reader.Read<uint64_t>());
+            }
+
+            const auto table_kind = reader.Read<TableKind>();
+            const RouteWeight* weights = nullptr;
+            const graph::EdgeId* prev_edges = nullptr;
+            const uint32_t* hub_vertices = nullptr;
+            const uint32_t* out_offsets = nullptr;
+            const uint32_t* in_offsets = nullptr;
+            const HubLabelRouter::LabelEntry* out_labels = nullptr;
+            const HubLabelRouter::LabelEntry* in_labels = nullptr;
+            uint8_t prev_edge_size = 0;
+            const void* predecessors = nullptr;
+            if (table_kind == TableKind::ALL_PAIRS) {
+                reader.Align(TABLE_ALIGNMENT);
+                const size_t table_size = vertex_count * vertex_count;
+                weights = reinterpret_cast<const RouteWeight*>(reader.Skip(table_size * sizeof(RouteWeight)));
+                prev_edges = reinterpret_cast<const graph::EdgeId*>(reader.Skip(table_size * sizeof(graph::EdgeId)));
+            } else if (table_kind == TableKind::HUB_LABELS) {
+                reader.Align(TABLE_ALIGNMENT);
+                hub_vertices = reinterpret_cast<const uint32_t*>(reader.Skip(vertex_count * sizeof(uint32_t)));
+                out_offsets = reinterpret_cast<const uint32_t*>(reader.Skip((vertex_count + 1) * sizeof(uint32_t)));
+                in_offsets = reinterpret_cast<const uint32_t*>(reader.Skip((vertex_count + 1) * sizeof(uint32_t)));
+                reader.Align(TABLE_ALIGNMENT);
+                out_labels = reinterpret_cast<const HubLabelRouter::LabelEntry*>(
+                    reader.Skip(out_offsets[vertex_count] * sizeof(HubLabelRouter::LabelEntry)));
+                in_labels = reinterpret_cast<const HubLabelRouter::LabelEntry*>(
+                    reader.Skip(in_offsets[vertex_count] * sizeof(HubLabelRouter::LabelEntry)));
+            } else if (table_kind == TableKind::PREDECESSORS) {
+                prev_edge_size = reader.Read<uint8_t>();
+                if (prev_edge_size != sizeof(uint16_t) && prev_edge_size != sizeof(uint32_t)) {
+                    return false;
+                }
+                reader.Align(TABLE_ALIGNMENT);
+                predecessors = reader.Skip(vertex_count * vertex_count * prev_edge_size);
+            } else if (table_kind != TableKind::NONE) {
+                return false;
+            }
+
+            compact_graph_ = CompactGraph(graph);
+            id_to_edge_infos_ = std::move(id_to_edge_infos);
+            pruned_edge_count_ = pruned_edge_count;
+            stop_to_id_vertices_ = std::move(stop_to_id_vertices);
+            vertex_to_stop_ = std::move(vertex_to_stop);
+            mapped_file_ = std::move(file);
+            if (table_kind == TableKind::ALL_PAIRS) {
+                router_ = std::make_unique<Router>(compact_graph_, weights, prev_edges);
+            } else if (table_kind == TableKind::HUB_LABELS) {
+                router_ = std::make_unique<HubLabelRouter>(compact_graph_, hub_vertices, out_offsets, out_labels,
+                                                           in_offsets, in_labels);
+            } else if (table_kind == TableKind::PREDECESSORS && prev_edge_size == sizeof(uint16_t)) {
+                router_ = std::make_unique<PredecessorRouter16>(compact_graph_,
+                                                                reinterpret_cast<const uint16_t*>(predecessors));
+            } else if (table_kind == TableKind::PREDECESSORS) {
+                router_ = std::make_unique<PredecessorRouter32>(compact_graph_,
+                                                                reinterpret_cast<const uint32_t*>(predecessors));
+            } else {
+                BuildRouter(); // для маршрутизаторов по запросу таблицы нет, построение быстрое
+            }
+        } catch (const std::exception&) { // повреждённый или обрезанный файл
+            return false;
+        }
+        return true;
+    }
+
     void TransportRouter::BuildGraph() {
-        graph_ = Graph(vertex_count_);
+        // при повторном построении описания рёбер и вершин прежнего графа не нужны
+        id_to_edge_infos_.clear();
+        stop_to_id_vertices_.clear();
+        vertex_to_stop_.clear();
+        const size_t riding_vertex_count = settings_.graph_model_ == GraphModel::ROUTE_PATTERNS ? CountRidingVertices() : 0;
+        graph_ = Graph(vertex_count_ + riding_vertex_count);
+        vertex_to_stop_.reserve(vertex_count_ + riding_vertex_count);
     }
 
     void TransportRouter::BuildRouter() {
-        router_ = std::make_unique<Router>(graph_);
+        ++build_stats_.router_builds;
+        switch (settings_.router_type_) {
+            case RouterType::ALL_PAIRS:
+                router_ = std::make_unique<Router>(compact_graph_, GetRouterThreadCount());
+                break;
+            case RouterType::DIJKSTRA:
+                router_ = std::make_unique<DijkstraRouter>(compact_graph_);
+                break;
+            case RouterType::CONTRACTION_HIERARCHY:
+                router_ = std::make_unique<ContractionHierarchyRouter>(compact_graph_);
+                break;
+            case RouterType::ASTAR:
+                ComputeMinRoadToGeoRatio();
+                router_ = std::make_unique<AStarRouter>(compact_graph_, [this](size_t vertex, size_t target) {
+                    // целая оценка округляется вниз и остаётся нижней
+                    return static_cast<RouteWeight>(ComputeMinRouteTime(vertex, target) * WEIGHT_UNITS_PER_MIN);
+                });
+                break;
+            case RouterType::HUB_LABELS:
+                router_ = std::make_unique<HubLabelRouter>(compact_graph_);
+                break;
+            case RouterType::ALL_PAIRS_COMPACT:
+                router_ = graph::MakePredecessorRouter(compact_graph_, GetRouterThreadCount());
+                break;
+            case RouterType::RAPTOR:
+                raptor_router_ = std::make_unique<RaptorRouter>(db_, settings_.bus_wait_time_,
+                    [this](const Stop* from, const Stop* to) {
+                        return ComputeRouteTime(from->name, to->name);
+                    },
+                    settings_.max_transfers_ ? *settings_.max_transfers_ + 1 : 0, GetRouterThreadCount());
+                break;
+        }
+    }
+
+    void TransportRouter::ReweightEdges(double scale) {
+        for (graph::EdgeId edge_id = 0; edge_id < id_to_edge_infos_.size(); ++edge_id) {
+            auto& edge_info = id_to_edge_infos_[edge_id];
+            if (auto* wait_edge_info = std::get_if<WaitEdgeInfo>(&edge_info)) {
+                wait_edge_info->time = settings_.bus_wait_time_;
+                compact_graph_.SetEdgeWeight(edge_id, ToRouteWeight(wait_edge_info->time));
+            } else if (scale != 1.0) { // для double вес ребра движения равен его времени
+                auto& bus_edge_info = std::get<BusEdgeInfo>(edge_info);
+                bus_edge_info.time *= scale;
+                compact_graph_.SetEdgeWeight(edge_id, ToRouteWeight(bus_edge_info.time));
+            }
+        }
+    }
+
+    void TransportRouter::ApplyGraphChanges(std::vector<bool> is_removed_edge) {
+        // из добавляемых параллельных рёбер остаётся самое быстрое; с ребром графа на тех же вершинах
+        // остаётся более быстрое, при равном времени - ребро графа
+        const size_t edge_count = compact_graph_.GetEdgeCount();
+        std::vector<graph::EdgeId> kept_edges;
+        graph::PruneDominatedEdges(graph_, kept_edges);
+        std::vector<bool> is_kept(graph_.GetEdgeCount(), false);
+        for (const graph::EdgeId edge_id : kept_edges) {
+            const auto& edge = graph_.GetEdge(edge_id);
+            is_kept[edge_id] = true;
+            if (edge.from >= compact_graph_.GetVertexCount()) {
+                continue;
+            }
+            for (const auto& arc : compact_graph_.GetArcs(edge.from)) {
+                if (arc.to != edge.to || is_removed_edge[arc.edge_id]) {
+                    continue;
+                }
+                if (edge.weight < arc.weight) {
+                    is_removed_edge[arc.edge_id] = true;
+                } else {
+                    is_kept[edge_id] = false;
+                }
+            }
+        }
+        FilterAddedEdges(is_kept);
+
+        // описания рёбер: прежние без удалённых, затем добавленные
+        std::vector<EdgeInfo> id_to_edge_infos;
+        id_to_edge_infos.reserve(id_to_edge_infos_.size());
+        for (graph::EdgeId edge_id = 0; edge_id < id_to_edge_infos_.size(); ++edge_id) {
+            if (edge_id >= edge_count || !is_removed_edge[edge_id]) {
+                id_to_edge_infos.push_back(std::move(id_to_edge_infos_[edge_id]));
+            }
+        }
+        id_to_edge_infos_ = std::move(id_to_edge_infos);
+
+        const auto edge_ids = compact_graph_.RemoveEdges(is_removed_edge);
+        const graph::EdgeId first_added_edge = compact_graph_.GetEdgeCount();
+        compact_graph_.AddEdges(graph_);
+        graph_ = Graph();
+        pruned_edge_count_ = CountGeneratedEdges() - compact_graph_.GetEdgeCount();
+
+        route_cache_.Clear();
+        alternative_search_.reset();
+        BuildTimetableRouter();
+        if (!router_->UpdateGraph(edge_ids, first_added_edge)) {
+            BuildRouter();
+        }
+    }
+
+    void TransportRouter::FilterAddedEdges(const std::vector<bool>& is_kept) {
+        const size_t edge_count = compact_graph_.GetEdgeCount();
+        Graph graph(graph_.GetVertexCount());
+        size_t kept_count = 0;
+        for (graph::EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+            if (is_kept[edge_id]) {
+                graph.AddEdge(graph_.GetEdge(edge_id));
+                id_to_edge_infos_[edge_count + kept_count++] = std::move(id_to_edge_infos_[edge_count + edge_id]);
+            }
+        }
+        graph_ = std::move(graph);
+        id_to_edge_infos_.resize(edge_count + kept_count);
+    }
+
+    void TransportRouter::UpdateRaptorRouter() {
+        SetVertexCount(db_.GetStops().size());
+        route_cache_.Clear();
+        BuildTimetableRouter();
+        BuildRouter();
+    }
+
+    void TransportRouter::BuildTimetableRouter() {
+        timetable_router_.reset();
+        const auto& buses = db_.GetBuses();
+        if (std::none_of(buses.begin(), buses.end(), [](const Bus& bus) { return !bus.departures.empty(); })) {
+            return;
+        }
+        timetable_router_ = std::make_unique<ConnectionScanRouter>(db_, [this](const Stop* from, const Stop* to) {
+            return ComputeRouteTime(from->name, to->name);
+        });
+    }
+
+    uint64_t TransportRouter::ComputeChecksum() const {
+        serialization::Checksum checksum;
+        checksum.Add(FILE_VERSION);
+        checksum.Add(static_cast<uint32_t>(settings_.router_type_));
+        checksum.Add(static_cast<uint32_t>(settings_.graph_model_));
+        checksum.Add(static_cast<uint32_t>(settings_.vertex_order_));
+        checksum.Add(static_cast<uint32_t>(sizeof(RouteWeight)));
+        checksum.Add(WEIGHT_UNITS_PER_MIN);
+        checksum.Add(static_cast<uint64_t>(settings_.max_transfers_ ? *settings_.max_transfers_ + 1 : 0));
+        checksum.Add(settings_.bus_wait_time_);
+        checksum.Add(settings_.bus_velocity_);
+        checksum.Add(static_cast<uint64_t>(vertex_count_));
+        for (const auto& stop : db_.GetStops()) {
+            checksum.AddString(stop.name);
+            checksum.Add(stop.coordinates.lat);
+            checksum.Add(stop.coordinates.lng);
+        }
+        for (const auto& bus : db_.GetBuses()) {
+            checksum.AddString(bus.name);
+            checksum.Add(bus.is_roundtrip);
+            for (size_t i = 0; i < bus.route.size(); ++i) {
+                checksum.AddString(bus.route[i]->name);
+                if (i + 1 < bus.route.size()) { // расстояния, из которых складывается время на рёбрах
+                    checksum.Add(db_.GetDistance(bus.route[i]->name, bus.route[i + 1]->name));
+                    checksum.Add(db_.GetDistance(bus.route[i + 1]->name, bus.route[i]->name));
+                }
+            }
+        }
+        return checksum.GetValue();
+    }
+
+    size_t TransportRouter::GetRouterThreadCount() const {
+        if (settings_.router_threads_ == 0) {
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+        return settings_.router_threads_;
     }
 
     const std::pair<size_t, size_t> TransportRouter::GetStopPairID(const std::string& stop_name) const {
         return stop_to_id_vertices_.at(db_.FindStop(stop_name));
     }
 
-    void TransportRouter::AddRouteToTransportRouter(const size_t from, const size_t to, const double time) {
-        graph_.AddEdge(Edge{ from, to, time });
+    void TransportRouter::AddRouteToTransportRouter(const size_t from, const size_t to, const RouteWeight weight) {
+        graph_.AddEdge(Edge{ from, to, weight });
     }
 
     double TransportRouter::ComputeRouteTime(const std::string& from_stop, const std::string& to_stop) const {
         return db_.GetDistance(from_stop, to_stop) / METERS_PER_KM / settings_.bus_velocity_ * MIN_PER_HOUR;
     }
 
-    void TransportRouter::AddWaitEdgeInfo(const std::string& stop_name, const double bus_wait_time) {
-        id_to_edge_infos_.emplace_back(WaitEdgeInfo{ stop_name, bus_wait_time }); //вынести в приват-метод
+    void TransportRouter::ComputeMinRoadToGeoRatio() {
+        min_road_to_geo_ratio_ = std::numeric_limits<double>::max();
+        for (const auto& bus : db_.GetBuses()) {
+            for (size_t i = 0; i + 1 < bus.route.size(); ++i) {
+                const double geo_distance = geo::ComputeDistance(bus.route[i]->coordinates, bus.route[i + 1]->coordinates);
+                if (geo_distance > 0.0) { // для совпадающих координат ограничения нет
+                    min_road_to_geo_ratio_ = std::min(min_road_to_geo_ratio_,
+                        db_.GetDistance(bus.route[i]->name, bus.route[i + 1]->name) / geo_distance);
+                }
+                if (!bus.is_roundtrip && geo_distance > 0.0) { // обратный перегон прямого маршрута
+                    min_road_to_geo_ratio_ = std::min(min_road_to_geo_ratio_,
+                        db_.GetDistance(bus.route[i + 1]->name, bus.route[i]->name) / geo_distance);
+                }
+            }
+        }
+        if (min_road_to_geo_ratio_ == std::numeric_limits<double>::max()) {
+            min_road_to_geo_ratio_ = 0.0;
+        }
+        // запас на погрешность вычислений, чтобы оценка не превышала точное время
+        min_road_to_geo_ratio_ *= 1.0 - 1e-9;
     }
 
-    void TransportRouter::AddBusEdgeInfo(const std::string& bus_name, const double time, const size_t span_count) {
-        id_to_edge_infos_.emplace_back(BusEdgeInfo{ bus_name, time, span_count });
+    double TransportRouter::ComputeMinRouteTime(const size_t vertex, const size_t target) const {
+        const Stop* stop = vertex_to_stop_[vertex];
+        const Stop* target_stop = vertex_to_stop_[target];
+        if (stop == target_stop) {
+            return 0.0;
+        }
+        // с вершины ожидания другой остановки единственное ребро - ожидание автобуса
+        const double wait_time = stop_to_id_vertices_.at(stop).first == vertex ? settings_.bus_wait_time_ : 0.0;
+        const double geo_distance = geo::ComputeDistance(stop->coordinates, target_stop->coordinates);
+        if (std::isnan(geo_distance)) { // acos от значения чуть больше 1 для очень близких точек
+            return wait_time;
+        }
+        return wait_time + geo_distance * min_road_to_geo_ratio_ / METERS_PER_KM / settings_.bus_velocity_ * MIN_PER_HOUR;
+    }
+
+    void TransportRouter::PruneDominatedEdges() {
+        std::vector<graph::EdgeId> kept_edges;
+        graph_ = graph::PruneDominatedEdges(graph_, kept_edges);
+        pruned_edge_count_ = id_to_edge_infos_.size() - kept_edges.size();
+
+        // описание ребра переходит к его новому id
+        std::vector<EdgeInfo> id_to_edge_infos;
+        id_to_edge_infos.reserve(kept_edges.size());
+        for (const graph::EdgeId edge_id : kept_edges) {
+            id_to_edge_infos.push_back(id_to_edge_infos_[edge_id]);
+        }
+        id_to_edge_infos_ = std::move(id_to_edge_infos);
+    }
+
+    void TransportRouter::AddWaitEdgeInfo(const StopId stop, const double bus_wait_time) {
+        id_to_edge_infos_.emplace_back(WaitEdgeInfo{ stop, bus_wait_time }); //вынести в приват-метод
+    }
+
+    void TransportRouter::AddBusEdgeInfo(const BusId bus, const double time, const uint32_t span_count) {
+        id_to_edge_infos_.emplace_back(BusEdgeInfo{ bus, time, span_count });
+    }
+
+    std::vector<const Stop*> TransportRouter::GetStopsInVertexOrder() const {
+        std::vector<const Stop*> stops;
+        for (const auto& stop : db_.GetStops()) {
+            stops.push_back(&stop);
+        }
+        if (settings_.vertex_order_ != VertexOrder::HILBERT || stops.empty()) {
+            return stops;
+        }
+
+        geo::Coordinates min = stops.front()->coordinates;
+        geo::Coordinates max = min;
+        for (const Stop* stop : stops) {
+            min = { std::min(min.lat, stop->coordinates.lat), std::min(min.lng, stop->coordinates.lng) };
+            max = { std::max(max.lat, stop->coordinates.lat), std::max(max.lng, stop->coordinates.lng) };
+        }
+        std::vector<std::pair<uint64_t, const Stop*>> indexed_stops;
+        indexed_stops.reserve(stops.size());
+        for (const Stop* stop : stops) {
+            indexed_stops.push_back({ geo::ComputeHilbertIndex(stop->coordinates, min, max), stop });
+        }
+        // остановки в одной клетке сетки остаются в порядке справочника
+        std::stable_sort(indexed_stops.begin(), indexed_stops.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.first < rhs.first;
+            });
+        for (size_t i = 0; i < stops.size(); ++i) {
+            stops[i] = indexed_stops[i].second;
+        }
+        return stops;
     }
 
     void TransportRouter::AddAllWaitEdgeInfos() {
-        size_t i = 0;
-        for (const auto& [ name, _ ] : db_.GetStops()) {
-            stop_to_id_vertices_[db_.FindStop(name)] = { i, i + 1 };
-            const double time = settings_.bus_wait_time_;
-            AddRouteToTransportRouter(i, i + 1, time); 
-            AddWaitEdgeInfo(name, time);
-            i += 2;
+        for (const Stop* stop : GetStopsInVertexOrder()) {
+            AddStopVertices(stop);
+        }
+    }
+
+    void TransportRouter::AddStopVertices(const Stop* stop) {
+        const size_t vertex = vertex_to_stop_.size();
+        stop_to_id_vertices_[stop] = { vertex, vertex + 1 };
+        vertex_to_stop_.push_back(stop);
+        vertex_to_stop_.push_back(stop);
+        const double time = settings_.bus_wait_time_;
+        AddRouteToTransportRouter(vertex, vertex + 1, ToRouteWeight(time));
+        AddWaitEdgeInfo(stop->id, time);
+    }
+
+    size_t TransportRouter::CountRidingVertices() const {
+        size_t count = 0;
+        for (const auto& bus : db_.GetBuses()) {
+            count += bus.is_roundtrip ? bus.route.size() : 2 * bus.route.size();
+        }
+        return count;
+    }
+
+    size_t TransportRouter::CountGeneratedEdges() const {
+        size_t count = stop_to_id_vertices_.size(); // рёбра ожидания
+        for (const auto& bus : db_.GetBuses()) {
+            const size_t stop_count = bus.route.size();
+            if (stop_count == 0) {
+                continue;
+            }
+            // ROUTE_PATTERNS: посадка, перегон и высадка на перегон; STOP_PAIRS: ребро на каждую пару остановок
+            const size_t direction_count = bus.is_roundtrip ? 1 : 2;
+            count += direction_count * (settings_.graph_model_ == GraphModel::ROUTE_PATTERNS
+                                        ? 3 * (stop_count - 1) : stop_count * (stop_count - 1) / 2);
+        }
+        return count;
+    }
+
+    void TransportRouter::AddBusEdges(const Bus& bus) {
+        const bool is_route_patterns = settings_.graph_model_ == GraphModel::ROUTE_PATTERNS;
+        if (is_route_patterns) {
+            AddRoutePatternEdgeInfos(bus.id, bus.route);
+        } else {
+            AddAllBusEdgeInfos(bus.id, bus.route);
+        }
+        if (!bus.is_roundtrip) { // // для прямого маршрута A,B,C,B,A путь туда-обратно A,B,C + C,B,A
+            std::vector<Stop const*> reversed_route(bus.route.rbegin(), bus.route.rend());
+            if (is_route_patterns) {
+                AddRoutePatternEdgeInfos(bus.id, reversed_route);
+            } else {
+                AddAllBusEdgeInfos(bus.id, std::move(reversed_route));
+            }
+        }
+    }
+
+    void TransportRouter::AddRoutePatternEdgeInfos(const BusId bus, const std::vector<const domain::Stop*>& route) {
+        // вершины движения нумеруются после вершин остановок и уже добавленных маршрутов
+        const size_t first_riding_vertex = vertex_to_stop_.size();
+        for (const Stop* stop : route) {
+            vertex_to_stop_.push_back(stop);
+        }
+        for (size_t i = 0; i + 1 < route.size(); ++i) {
+            const size_t riding_vertex = first_riding_vertex + i;
+
+            // посадка на остановке i (после ожидания) и перегон до остановки i + 1
+            AddRouteToTransportRouter(stop_to_id_vertices_[route[i]].second, riding_vertex, RouteWeight{});
+            AddBusEdgeInfo(bus, 0.0, 0);
+            const double time = ComputeRouteTime(route[i]->name, route[i + 1]->name);
+            AddRouteToTransportRouter(riding_vertex, riding_vertex + 1, ToRouteWeight(time));
+            AddBusEdgeInfo(bus, time, 1);
+
+            // высадка на остановке i + 1
+            AddRouteToTransportRouter(riding_vertex + 1, stop_to_id_vertices_[route[i + 1]].first, RouteWeight{});
+            AddBusEdgeInfo(bus, 0.0, 0);
         }
     }
 
-    void TransportRouter::AddAllBusEdgeInfos(const std::string& bus_name, const std::vector<const domain::Stop*>& route) {    
-        for (size_t i = 0; i < route.size() - 1; i++) { // остановка from
+    void TransportRouter::AddAllBusEdgeInfos(const BusId bus, const std::vector<const domain::Stop*>& route) {    
+        for (size_t i = 0; i + 1 < route.size(); i++) { // остановка from
             double time = 0;
-            size_t span_count = 0;
+            RouteWeight weight{}; // сумма весов перегонов: для целых весов ребро равно пути по перегонам (как в ROUTE_PATTERNS)
+            uint32_t span_count = 0;
             size_t prev = i;
             const size_t from = stop_to_id_vertices_[route[i]].second;
             for (size_t j = i + 1; j < route.size(); j++) { // остановка to
                 //std::cerr << "bus edge: " << i << " -> " << j << std::endl;
-                //std::cerr << bus_name << ": " << route[i]->name << " -> " << route[j]->name << std::endl;
+                //std::cerr << bus << ": " << route[i]->name << " -> " << route[j]->name << std::endl;
                 const size_t to = stop_to_id_vertices_[route[j]].first;
                 span_count += 1;
-                time += ComputeRouteTime(route[prev]->name, route[j]->name);
+                const double segment_time = ComputeRouteTime(route[prev]->name, route[j]->name);
+                time += segment_time;
+                weight += ToRouteWeight(segment_time);
                 prev = j;       
-                AddRouteToTransportRouter(from, to, time);
-                AddBusEdgeInfo(bus_name, time, span_count);
+                AddRouteToTransportRouter(from, to, weight);
+                AddBusEdgeInfo(bus, time, span_count);
             }
         }
     }
@@ -2,12 +2,33 @@
 
 #include "transport_catalogue.h"
 #include "domain.h"
+#include "geo.h"
 #include "router.h"
+#include "serialization.h"
+#include "dijkstra_router.h"
+#include "ch_router.h"
+#include "hub_label_router.h"
+#include "predecessor_router.h"
+#include "pareto_search.h"
+#include "alternative_routes.h"
+#include "raptor_router.h"
+#include "connection_scan_router.h"
 #include "graph.h"
+#include "lru_cache.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <variant>
 #include <vector>
 
@@ -22,14 +43,76 @@ namespace transport_router {
 constexpr static double METERS_PER_KM = 1000.0;
 constexpr static double MIN_PER_HOUR = 60.0;
 
+/*
+вес рёбер графа. По умолчанию - время в минутах (double). При сборке с TRANSPORT_ROUTER_FIXED_POINT -
+целое число сотых долей секунды (uint32_t, до ~497 суток на маршрут): таблица всех пар вдвое меньше,
+релаксация строки идёт целочисленным ядром AVX2, а сумма весов не зависит от порядка сложения,
+поэтому выбор среди равных маршрутов одинаков у всех маршрутизаторов
+*/
+#if defined(TRANSPORT_ROUTER_FIXED_POINT)
+using RouteWeight = uint32_t;
+constexpr static double WEIGHT_UNITS_PER_MIN = 6000.0;
+#else
+using RouteWeight = double;
+constexpr static double WEIGHT_UNITS_PER_MIN = 1.0;
+#endif
+
+/*
+время в минутах в вес ребра. Целый вес округляется вверх, чтобы нижняя оценка A* (округляемая вниз)
+оставалась согласованной; допуск убирает погрешность умножения для времени, кратного единице веса
+*/
+inline RouteWeight ToRouteWeight(double time) {
+    if constexpr (std::is_floating_point_v<RouteWeight>) {
+        return time;
+    } else {
+        return static_cast<RouteWeight>(std::ceil(time * WEIGHT_UNITS_PER_MIN - 1e-6));
+    }
+}
+
+// вес маршрута в минуты
+inline double ToRouteTime(RouteWeight weight) {
+    return weight / WEIGHT_UNITS_PER_MIN;
+}
+
 // ребро маршрута
-using Edge = graph::Edge<double>;
+using Edge = graph::Edge<RouteWeight>;
 
 // тип графа
-using Graph = graph::DirectedWeightedGraph<double>;
+using Graph = graph::DirectedWeightedGraph<RouteWeight>;
+
+// граф в сжатом формате, по которому работают маршрутизаторы
+using CompactGraph = graph::CompactGraph<RouteWeight>;
 
 //тип маршрутизатора
-using Router = graph::Router<double>;
+using Router = graph::Router<RouteWeight>;
+
+// маршрутизатор с поиском по запросу
+using DijkstraRouter = graph::DijkstraRouter<RouteWeight>;
+
+// маршрутизатор с целенаправленным поиском по запросу
+using AStarRouter = graph::AStarRouter<RouteWeight>;
+
+// маршрутизатор по иерархии сжатия
+using ContractionHierarchyRouter = graph::ContractionHierarchyRouter<RouteWeight>;
+
+// маршрутизатор по меткам-хабам
+using HubLabelRouter = graph::HubLabelRouter<RouteWeight>;
+
+// маршрутизаторы с таблицей последних рёбер маршрутов всех пар (16- и 32-битные номера рёбер)
+using PredecessorRouter16 = graph::PredecessorRouter<RouteWeight, uint16_t>;
+using PredecessorRouter32 = graph::PredecessorRouter<RouteWeight, uint32_t>;
+
+// поиск альтернативных маршрутов методом плато
+using AlternativeRouteSearch = graph::AlternativeRouteSearch<RouteWeight>;
+
+// общий интерфейс маршрутизаторов
+using RouterBase = graph::RouterBase<RouteWeight>;
+
+// счётчики построений: графа по справочнику и предрасчёта маршрутизатора (таблицы, меток) по графу
+struct BuildStats {
+    size_t graph_builds = 0;
+    size_t router_builds = 0;
+};
 
 
 class TransportRouter {
@@ -37,7 +120,7 @@ public:
     explicit TransportRouter(transport_catalogue::TransportCatalogue& db)
         : db_(db) {}
 
-    // задаёт настройки маршрутизации: скорость автобуса и время ожидания на остановке
+    // задаёт настройки маршрутизации: скорость автобуса и время ожидания на остановке; кэш маршрутов очищается
     void SetRouterSettings(const domain::RouterSettings& settings);
 
     // задаёт количество узлов на графе для задания графа
@@ -46,44 +129,244 @@ public:
     // задаёт все рёбра графа по парам вершин и весу ребра из EdgeInfo
     void BuildTransportRouter();
 
-    // возвращает вектор рёбер для оптимального маршрута
+    /*
+    задаёт новые настройки построенному маршрутизатору того же справочника. Если поменялись только время ожидания
+    и скорость, граф не перестраивается: веса рёбер ожидания заменяются, веса рёбер движения умножаются
+    на отношение скоростей, и заново выполняется только предрасчёт маршрутизатора. Если все веса умножились
+    на одно число (время ожидания изменилось в то же число раз, что и время в пути), кратчайшие маршруты те же
+    и таблицы всех пар масштабируются без предрасчёта. Иначе (и для целых весов при смене скорости:
+    вес ребра - сумма округлённых перегонов) маршрутизатор строится заново
+    */
+    void UpdateRouterSettings(const domain::RouterSettings& settings);
+
+    /*
+    изменения справочника в построенном маршрутизаторе без нового построения; справочник уже изменён
+    (TransportCatalogue::AddStop, AddBus, RemoveBus). В граф добавляются вершины остановки (AddStop; AddBus -
+    для новых остановок маршрута) и рёбра автобуса или удаляются рёбра удалённого автобуса, параллельные рёбра
+    отбираются как при построении. Таблица ALL_PAIRS обновляется только для затронутых маршрутов,
+    остальные маршрутизаторы строятся заново по изменённому графу, RAPTOR - по справочнику.
+    Новые вершины нумеруются после прежних (без порядка vertex_order_), вершины движения удалённого
+    автобуса в модели ROUTE_PATTERNS остаются без рёбер. Маршрутизатор, который ещё не построен, не меняется
+    */
+    void AddStop(const domain::Stop& stop);
+    void AddBus(const domain::Bus& bus);
+    void RemoveBus(const domain::Bus& bus);
+
+    /*
+    сохраняет построенный граф, описания рёбер, вершины остановок, таблицу маршрутов (для ALL_PAIRS и ALL_PAIRS_COMPACT)
+    или метки (для HUB_LABELS)
+    в двоичный файл версии FILE_VERSION с контрольной суммой справочника и настроек маршрутизации
+    и контрольной суммой всего содержимого в конце файла
+    */
+    void SaveToFile(const std::string& path) const;
+
+    /*
+    загружает маршрутизатор из файла, сохранённого SaveToFile, вместо BuildTransportRouter:
+    таблица маршрутов и метки не копируются, а отображаются в память. Возвращает false, если файла нет,
+    он повреждён или построен для другого справочника или других настроек
+    */
+    bool LoadFromFile(const std::string& path);
+
+    /*
+    возвращает вектор рёбер для оптимального маршрута; при route_cache_capacity_ > 0 готовые маршруты
+    (и их отсутствие) берутся из кэша по паре номеров остановок
+    */
     std::optional<domain::RouteInfo> GetOptimalRoute(const std::string& from_stop, const std::string& to_stop) const;
 
+    // то же со счётчиками поиска (просмотренные вершины и релаксированные рёбра) для маршрутизаторов по запросу,
+    // при попадании в кэш счётчики нулевые
+    std::optional<domain::RouteInfo> GetOptimalRoute(const std::string& from_stop, const std::string& to_stop,
+                                                     graph::SearchStats& stats) const;
+
+    // оптимальные маршруты от одной остановки до нескольких: для маршрутизаторов по запросу один поиск на все промахи кэша
+    std::vector<std::optional<domain::RouteInfo>> GetOptimalRoutes(const std::string& from_stop,
+                                                                   const std::vector<std::string>& to_stops) const;
+
+    /*
+    маршруты, оптимальные по Парето по времени и числу ожиданий (поездок), за один поиск: самый быстрый
+    и более медленные с меньшим числом пересадок, по возрастанию времени. Для графа - поиск с мешками меток,
+    для RAPTOR - маршруты раундов; число поездок ограничено max_transfers_ + 1, если оно задано.
+    Пустой вектор - маршрута нет, nullopt - остановки нет в справочнике
+    */
+    std::optional<std::vector<domain::RouteInfo>> GetParetoRoutes(const std::string& from_stop,
+                                                                  const std::string& to_stop) const;
+
+    /*
+    до count различающихся маршрутов по возрастанию времени, первый - оптимальный: альтернативы не длиннее
+    max_stretch оптимального и делят с каждым выбранным маршрутом не больше max_sharing его времени.
+    Все маршруты берутся из двух деревьев кратчайших путей (метод плато); для RAPTOR графа нет -
+    только оптимальный маршрут. Пустой вектор - маршрута нет, nullopt - остановки нет в справочнике
+    */
+    std::optional<std::vector<domain::RouteInfo>> GetAlternativeRoutes(const std::string& from_stop,
+                                                                       const std::string& to_stop, size_t count) const;
+
+    /*
+    маршрут с самым ранним прибытием при отправлении из from_stop не раньше departure_time (минуты от начала суток)
+    по расписаниям автобусов (поиск Connection Scan, не зависит от типа маршрутизатора): ожидания - фактические
+    до отправления рейсов, время маршрута - от departure_time до прибытия. Кэш маршрутов не используется.
+    nullopt - остановки нет, маршрута нет или в справочнике нет расписаний
+    */
+    std::optional<domain::RouteInfo> GetTimetableRoute(const std::string& from_stop, const std::string& to_stop,
+                                                       double departure_time) const;
+
+    // то же со счётчиками поиска (улучшенные времена прибытия и просмотренные связи)
+    std::optional<domain::RouteInfo> GetTimetableRoute(const std::string& from_stop, const std::string& to_stop,
+                                                       double departure_time, graph::SearchStats& stats) const;
+
+    // построен ли (или загружен) маршрутизатор
+    bool IsBuilt() const;
+
+    // число доминируемых параллельных рёбер, удалённых из графа при построении
+    size_t GetPrunedEdgeCount() const;
+
+    // счётчики кэша маршрутов: попадания, промахи, вытеснения и число маршрутов в кэше
+    lru_cache::CacheStats GetRouteCacheStats() const;
+
+    // сколько раз строились граф и маршрутизатор (загрузка из файла не считается)
+    BuildStats GetBuildStats() const;
+
+    /*
+    время маршрутов всех пар остановок отправления и прибытия без сборки описаний маршрутов:
+    маршрутизатор считает всю матрицу сразу (корзины для CH, один поиск на строку для поиска по запросу)
+    */
+    domain::TravelTimes GetTravelTimes(const std::vector<std::string>& from_stops,
+                                       const std::vector<std::string>& to_stops) const;
+
+    /*
+    остановки, достижимые из from_stop не более чем за time_budget минут, по возрастанию времени (запрос Isochrone):
+    поиск Дейкстры по графу с остановкой по бюджету, таблица маршрутизатора не используется.
+    nullopt, если остановки нет в справочнике; при отрицательном бюджете список пуст
+    */
+    std::optional<std::vector<domain::ReachableStop>> GetReachableStops(const std::string& from_stop,
+                                                                        double time_budget) const;
+
 private:
+    static constexpr char FILE_MAGIC[8] = {'T', 'C', 'R', 'O', 'U', 'T', 'E', 'R'};
+    static constexpr uint32_t FILE_VERSION = 6;
+    static constexpr size_t TABLE_ALIGNMENT = 64;
+
+    // предрасчитанные данные маршрутизатора в файле
+    enum class TableKind : uint8_t {
+        NONE, // маршрутизатор по запросу строится заново
+        ALL_PAIRS, // таблица маршрутов всех пар
+        HUB_LABELS, // метки-хабы
+        PREDECESSORS // таблица последних рёбер маршрутов всех пар с шириной номера ребра в байтах
+    };
+
     const transport_catalogue::TransportCatalogue& db_; 
     domain::RouterSettings settings_;
-    size_t vertex_count_;
-    Graph graph_; 
-    std::unique_ptr<Router> router_;
-    std::vector<domain::EdgeInfo> id_to_edge_infos_; // id ребра - информация о ребре
+    size_t vertex_count_; // вершины остановок (ожидание и автобус), без вершин движения
+    Graph graph_; // заполняется при построении и освобождается после сжатия
+    CompactGraph compact_graph_; 
+    std::unique_ptr<RouterBase> router_;
+    std::unique_ptr<RaptorRouter> raptor_router_; // для RAPTOR граф не строится и router_ пуст
+    std::unique_ptr<ConnectionScanRouter> timetable_router_; // только если у автобусов есть расписания
+    mutable std::unique_ptr<AlternativeRouteSearch> alternative_search_; // входящие дуги строятся при первом запросе
+    std::vector<domain::EdgeInfo> id_to_edge_infos_; // id ребра - информация о ребре (номера автобуса или остановки)
     std::unordered_map<const domain::Stop*, std::pair<size_t, size_t>> stop_to_id_vertices_; // словарь остановка - пара id их вершин (с первой уезжаем, на вторую приезжаем)
+    std::vector<const domain::Stop*> vertex_to_stop_; // id вершины - остановка
+    size_t pruned_edge_count_ = 0; // удалённые параллельные рёбра с не меньшим временем
+    BuildStats build_stats_;
+    double min_road_to_geo_ratio_ = 0.0; // минимальное отношение дорожного расстояния к географическому по всем перегонам
+    serialization::MappedFile mapped_file_; // файл, из которого загружен маршрутизатор (владеет таблицей маршрутов)
+
+    // кэш готовых маршрутов: ключ - номера остановок отправления и прибытия, очищается при перестроении
+    mutable lru_cache::LruCache<uint64_t, std::optional<domain::RouteInfo>> route_cache_;
+
+    // ключ кэша маршрутов по паре остановок
+    static uint64_t GetRouteCacheKey(const domain::Stop* from, const domain::Stop* to);
+
+    // поиск маршрута без кэша
+    std::optional<domain::RouteInfo> FindOptimalRoute(const domain::Stop* from, const domain::Stop* to,
+                                                      graph::SearchStats& stats) const;
+
+    // поиск маршрутов от одной остановки до нескольких без кэша
+    std::vector<std::optional<domain::RouteInfo>> FindOptimalRoutes(const domain::Stop* from,
+                                                                    const std::vector<const domain::Stop*>& to) const;
 
     // строит граф
     void BuildGraph();
         
-    // строит маршрутизатор
+    // строит маршрутизатор выбранного в настройках типа
     void BuildRouter();
 
+    // строит поиск по расписаниям, если хотя бы у одного автобуса есть расписание
+    void BuildTimetableRouter();
+
+    // пересчитывает веса рёбер графа и описания рёбер под settings_: время ожидания - новое, время движения * scale
+    void ReweightEdges(double scale);
+
+    /*
+    применяет к графу изменение: удаляет рёбра is_removed_edge и добавляет вершины и рёбра graph_ с описаниями
+    в конце id_to_edge_infos_ (после описаний рёбер compact_graph_), затем обновляет маршрутизатор
+    */
+    void ApplyGraphChanges(std::vector<bool> is_removed_edge);
+
+    // оставляет из добавляемых рёбер graph_ отмеченные в is_kept вместе с их описаниями
+    void FilterAddedEdges(const std::vector<bool>& is_kept);
+
+    // строит RAPTOR и поиск по расписаниям по изменённому справочнику
+    void UpdateRaptorRouter();
+
+    // контрольная сумма данных справочника и настроек, от которых зависит маршрутизатор
+    uint64_t ComputeChecksum() const;
+
+    // возвращает число потоков построения маршрутизатора из настроек (0 - по числу ядер)
+    size_t GetRouterThreadCount() const;
+
+    // собирает описание маршрута по рёбрам, найденным маршрутизатором
+    domain::RouteInfo MakeRouteInfo(const RouterBase::RouteInfo& route) const;
+
     // Возвращает пару вершин для остановки from, to
     const std::pair<size_t, size_t> GetStopPairID(const std::string& stop_name) const;
 
+    // удаляет из graph_ доминируемые параллельные рёбра и их описания из id_to_edge_infos_
+    void PruneDominatedEdges();
+
     // создаёт ребро маршрута
-    void AddRouteToTransportRouter(const size_t from, const size_t to, const double time);
+    void AddRouteToTransportRouter(const size_t from, const size_t to, const RouteWeight weight);
 
     // вычисляет время на ребре маршрута
     double ComputeRouteTime(const std::string& from_stop, const std::string& to_stop) const;
 
+    // вычисляет min_road_to_geo_ratio_ по всем перегонам маршрутов
+    void ComputeMinRoadToGeoRatio();
+
+    // нижняя оценка времени от вершины до вершины target: географическое расстояние на скорости автобуса
+    double ComputeMinRouteTime(const size_t vertex, const size_t target) const;
+
     // добавляет описание для ребра ожидания (пересадка)
-    void AddWaitEdgeInfo(const std::string& stop_name, const double bus_wait_time);
+    void AddWaitEdgeInfo(const domain::StopId stop, const double bus_wait_time);
 
     // добавляет описание для ребра движения
-    void AddBusEdgeInfo(const std::string& bus_name, const double time, const size_t span_count);
+    void AddBusEdgeInfo(const domain::BusId bus, const double time, const uint32_t span_count);
+
+    // остановки в порядке нумерации их вершин по настройке vertex_order_
+    std::vector<const domain::Stop*> GetStopsInVertexOrder() const;
 
     // добавляет описание для всех рёбер ожидания (пересадка)
     void AddAllWaitEdgeInfos();
 
+    // добавляет пару вершин остановки после имеющихся вершин и ребро ожидания между ними
+    void AddStopVertices(const domain::Stop* stop);
+
+    // добавляет рёбра автобуса по модели графа (для прямого маршрута - в обе стороны)
+    void AddBusEdges(const domain::Bus& bus);
+
     // добавляет описание для всех рёбер движения
-    void AddAllBusEdgeInfos(const std::string& bus_name, const std::vector<const domain::Stop*>& route);
+    void AddAllBusEdgeInfos(const domain::BusId bus, const std::vector<const domain::Stop*>& route);
+
+    /*
+    модель ROUTE_PATTERNS: вершины движения на автобусе по каждой остановке маршрута, связанные рёбрами перегонов,
+    ребро посадки из вершины автобуса остановки и ребро высадки в вершину ожидания (оба нулевого веса)
+    */
+    void AddRoutePatternEdgeInfos(const domain::BusId bus, const std::vector<const domain::Stop*>& route);
+
+    // число вершин движения на автобусе в модели ROUTE_PATTERNS
+    size_t CountRidingVertices() const;
+
+    // число рёбер графа до удаления параллельных: ожидания и рёбра всех автобусов по модели графа
+    size_t CountGeneratedEdges() const;
 
 };
 